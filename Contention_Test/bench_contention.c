@@ -0,0 +1,140 @@
+/**
+  \file : bench_contention.c
+  \author :   Sreeram Sadasivam
+  \brief  : Contention benchmark for the process queue read side. Registers a
+            set of worker processes with the custom scheduler and hammers
+            /proc/process_sched_add with concurrent readers while the
+            scheduler keeps switching, reporting read throughput and latency.
+
+            Usage: ./bench_contention.out [readers] [workers] [seconds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/**Macros*/
+#define PROC_FILE       "/proc/process_sched_add"
+#define DEF_READERS     16
+#define DEF_WORKERS     8
+#define DEF_SECONDS     10
+#define MAX_READERS     256
+#define MAX_WORKERS     256
+
+/**Per reader statistics.*/
+struct reader_stats {
+  unsigned long ops;      /**Completed open/read/close cycles.*/
+  unsigned long long total_ns;  /**Accumulated cycle time.*/
+  unsigned long long max_ns;    /**Worst cycle time.*/
+};
+
+static volatile int stop_flag = 0;
+
+static unsigned long long now_ns(void) {
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**Worker registering itself with the scheduler and spinning until killed.*/
+static void worker(void) {
+
+  volatile unsigned long spin = 0;
+  FILE *fp = fopen(PROC_FILE, "w");
+  if (fp == NULL) {
+    perror("fopen " PROC_FILE);
+    exit(1);
+  }
+  fprintf(fp, "%d", getpid());
+  fclose(fp);
+
+  while (1) {
+    spin++;
+  }
+}
+
+/**Reader thread timing every read of the proc file.*/
+static void *reader(void *arg) {
+
+  struct reader_stats *st = arg;
+  char buf[64];
+
+  while (!stop_flag) {
+    unsigned long long t0 = now_ns(), dt;
+    int fd = open(PROC_FILE, O_RDONLY);
+    if (fd < 0) {
+      perror("open " PROC_FILE);
+      break;
+    }
+    if (read(fd, buf, sizeof(buf)) < 0) {
+      perror("read " PROC_FILE);
+    }
+    close(fd);
+    dt = now_ns() - t0;
+    st->ops++;
+    st->total_ns += dt;
+    if (dt > st->max_ns) {
+      st->max_ns = dt;
+    }
+  }
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+
+  int readers = argc > 1 ? atoi(argv[1]) : DEF_READERS;
+  int workers = argc > 2 ? atoi(argv[2]) : DEF_WORKERS;
+  int seconds = argc > 3 ? atoi(argv[3]) : DEF_SECONDS;
+  pthread_t threads[MAX_READERS];
+  struct reader_stats stats[MAX_READERS] = {{0}};
+  pid_t pids[MAX_WORKERS];
+  unsigned long ops = 0;
+  unsigned long long total_ns = 0, max_ns = 0;
+  int i;
+
+  if (readers < 1 || readers > MAX_READERS || workers < 0 || workers > MAX_WORKERS || seconds < 1) {
+    fprintf(stderr, "usage: %s [readers<=%d] [workers<=%d] [seconds]\n", argv[0], MAX_READERS, MAX_WORKERS);
+    return 1;
+  }
+
+  /**Populate the queue so the scheduler tick has work to do.*/
+  for (i = 0; i < workers; i++) {
+    pids[i] = fork();
+    if (pids[i] == 0) {
+      worker();
+    }
+  }
+  sleep(1);
+
+  for (i = 0; i < readers; i++) {
+    pthread_create(&threads[i], NULL, reader, &stats[i]);
+  }
+  sleep(seconds);
+  stop_flag = 1;
+  for (i = 0; i < readers; i++) {
+    pthread_join(threads[i], NULL);
+    ops += stats[i].ops;
+    total_ns += stats[i].total_ns;
+    if (stats[i].max_ns > max_ns) {
+      max_ns = stats[i].max_ns;
+    }
+  }
+
+  for (i = 0; i < workers; i++) {
+    kill(pids[i], SIGKILL);
+    waitpid(pids[i], NULL, 0);
+  }
+
+  printf("readers=%d workers=%d seconds=%d\n", readers, workers, seconds);
+  printf("reads/s: %.0f\n", (double)ops / seconds);
+  printf("avg read latency: %.1f us\n", ops ? (double)total_ns / ops / 1000.0 : 0.0);
+  printf("max read latency: %.1f us\n", (double)max_ns / 1000.0);
+  return 0;
+}
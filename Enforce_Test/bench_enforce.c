@@ -0,0 +1,179 @@
+/**
+  \file : bench_enforce.c
+  \author :   Sreeram Sadasivam
+  \brief  : Enforcement benchmark for the custom scheduler. Registers a set of
+            CPU bound worker processes and reads the switch statistics of
+            /proc/process_sched_add before and after the run, reporting what
+            stopping and continuing the tasks cost with the enforcement backend
+            process_queue.ko was loaded with. With the freezer backend every
+            worker first moves into a cgroup of its own. Run it once per
+            backend and compare the cost per task state change.
+
+            Usage: ./bench_enforce.out [workers] [seconds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/**Macros*/
+#define PROC_FILE       "/proc/process_sched_add"
+#define ENFORCE_PARAM   "/sys/module/process_queue/parameters/enforce"
+#define CGROUP_DIR      "/sys/fs/cgroup/bench_enforce"
+#define DEF_WORKERS     8
+#define DEF_SECONDS     10
+#define MAX_WORKERS     256
+
+/**Switch statistics summed over the CPUs.*/
+struct enforce_stats {
+  unsigned long long ticks;         /**Switch requests served.*/
+  unsigned long long switches;      /**Switches that changed the running process.*/
+  unsigned long long tick_ns;       /**Time spent serving the switch requests.*/
+  unsigned long long enforced;      /**Task state changes applied.*/
+  unsigned long long enforce_ns;    /**Time spent applying them.*/
+  unsigned long long enforce_max_ns;  /**Longest state change.*/
+  unsigned long long coalesced;     /**State changes replaced by a later one before being applied.*/
+  unsigned long long dispatch_p50_ns; /**Median latency from continue to on CPU, all CPUs.*/
+  unsigned long long dispatch_p99_ns; /**99th percentile of it.*/
+};
+
+static char backend[32] = "signal";
+
+/**Worker moving into its own cgroup when needed, registering itself and spinning until killed.*/
+static void worker(int id) {
+
+  volatile unsigned long spin = 0;
+  char path[128];
+  FILE *fp;
+
+  if (strcmp(backend, "freezer") == 0) {
+    snprintf(path, sizeof(path), CGROUP_DIR "/w%d", id);
+    mkdir(path, 0755);
+    strncat(path, "/cgroup.procs", sizeof(path) - strlen(path) - 1);
+    fp = fopen(path, "w");
+    if (fp == NULL) {
+      perror(path);
+      exit(1);
+    }
+    fprintf(fp, "%d", getpid());
+    fclose(fp);
+  }
+  fp = fopen(PROC_FILE, "w");
+  if (fp == NULL) {
+    perror("fopen " PROC_FILE);
+    exit(1);
+  }
+  fprintf(fp, "%d", getpid());
+  fclose(fp);
+
+  while (1) {
+    spin++;
+  }
+}
+
+/**Reading the statistics of the queue, the per CPU averages are turned back into sums.*/
+static int read_stats(struct enforce_stats *st) {
+
+  char line[1024], name[16], cpu[16];
+  unsigned long long v[9], count, p50, p99;
+  FILE *fp = fopen(PROC_FILE, "r");
+
+  if (fp == NULL) {
+    perror("fopen " PROC_FILE);
+    return -1;
+  }
+  memset(st, 0, sizeof(*st));
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    if (sscanf(line, "%llu %llu %llu %llu %llu %llu %llu %llu %llu",
+               &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8]) == 9) {
+      st->ticks += v[1];
+      st->switches += v[2];
+      st->tick_ns += v[3] * v[1];
+      st->enforced += v[5];
+      st->enforce_ns += v[6] * v[5];
+      if (v[7] > st->enforce_max_ns) {
+        st->enforce_max_ns = v[7];
+      }
+      st->coalesced += v[8];
+    }
+    else if (sscanf(line, "%15s %15s %llu %llu %llu", name, cpu, &count, &p50, &p99) == 5 &&
+             strcmp(name, "dispatch") == 0 && strcmp(cpu, "all") == 0) {
+      st->dispatch_p50_ns = p50;
+      st->dispatch_p99_ns = p99;
+    }
+  }
+  fclose(fp);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+
+  int workers = argc > 1 ? atoi(argv[1]) : DEF_WORKERS;
+  int seconds = argc > 2 ? atoi(argv[2]) : DEF_SECONDS;
+  struct enforce_stats before, after;
+  unsigned long long enforced, ticks;
+  pid_t pids[MAX_WORKERS];
+  char path[128];
+  FILE *fp;
+  int i;
+
+  if (workers < 1 || workers > MAX_WORKERS || seconds < 1) {
+    fprintf(stderr, "usage: %s [workers<=%d] [seconds]\n", argv[0], MAX_WORKERS);
+    return 1;
+  }
+  fp = fopen(ENFORCE_PARAM, "r");
+  if (fp != NULL) {
+    if (fscanf(fp, "%31s", backend) != 1) {
+      strcpy(backend, "signal");
+    }
+    fclose(fp);
+  }
+  if (strcmp(backend, "freezer") == 0) {
+    mkdir(CGROUP_DIR, 0755);
+  }
+
+  for (i = 0; i < workers; i++) {
+    pids[i] = fork();
+    if (pids[i] == 0) {
+      worker(i);
+    }
+  }
+  /**Letting every worker register before the measurement starts.*/
+  sleep(1);
+  if (read_stats(&before) != 0) {
+    return 1;
+  }
+  sleep(seconds);
+  if (read_stats(&after) != 0) {
+    return 1;
+  }
+
+  for (i = 0; i < workers; i++) {
+    kill(pids[i], SIGKILL);
+    waitpid(pids[i], NULL, 0);
+  }
+  if (strcmp(backend, "freezer") == 0) {
+    for (i = 0; i < workers; i++) {
+      snprintf(path, sizeof(path), CGROUP_DIR "/w%d", i);
+      rmdir(path);
+    }
+    rmdir(CGROUP_DIR);
+  }
+
+  enforced = after.enforced - before.enforced;
+  ticks = after.ticks - before.ticks;
+  printf("enforce=%s workers=%d seconds=%d\n", backend, workers, seconds);
+  printf("switches/s: %.0f\n", (double)(after.switches - before.switches) / seconds);
+  printf("state changes/s: %.0f\n", (double)enforced / seconds);
+  printf("avg state change: %.1f us\n", enforced ? (double)(after.enforce_ns - before.enforce_ns) / enforced / 1000.0 : 0.0);
+  printf("max state change: %.1f us\n", (double)after.enforce_max_ns / 1000.0);
+  printf("coalesced state changes: %llu\n", after.coalesced - before.coalesced);
+  printf("avg switch request: %.1f us\n", ticks ? (double)(after.tick_ns - before.tick_ns) / ticks / 1000.0 : 0.0);
+  printf("dispatch latency p50/p99: %.1f/%.1f us\n", after.dispatch_p50_ns / 1000.0, after.dispatch_p99_ns / 1000.0);
+  return 0;
+}
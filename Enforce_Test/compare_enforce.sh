@@ -0,0 +1,12 @@
+# Runs bench_enforce.out once per enforcement backend of process_queue.ko.
+# Expects the modules to be built and loaded (make load), every module is
+# reloaded for each backend. Arguments are passed through to bench_enforce.out.
+cd "$(dirname "$0")"
+for enforce in signal freezer park
+do
+	sh ../scheduler/rmmod_scr.sh
+	sudo insmod ../scheduler/process_queue.ko enforce=$enforce
+	sudo insmod ../scheduler/process_scheduler.ko time_quantum_us=10000
+	sudo insmod ../scheduler/process_set.ko
+	sudo ./bench_enforce.out "$@"
+done
@@ -0,0 +1,160 @@
+/**
+  \file : bench_policy.c
+  \author :   Sreeram Sadasivam
+  \brief  : Policy benchmark for the custom scheduler. Registers a mix of CPU
+            bound and interactive worker processes, the CPU bound ones count
+            loop iterations, the interactive ones sleep for a short period and
+            measure how late they wake up. Run it once per policy loaded into
+            process_scheduler.ko and compare throughput and response times.
+
+            Usage: ./bench_policy.out [cpu_workers] [io_workers] [seconds] [sleep_us]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/**Macros*/
+#define PROC_FILE       "/proc/process_sched_add"
+#define DEF_CPU_WORKERS 4
+#define DEF_IO_WORKERS  4
+#define DEF_SECONDS     20
+#define DEF_SLEEP_US    2000
+#define MAX_WORKERS     64
+#define MAX_SAMPLES     65536
+
+/**Results published by one worker, shared with the parent.*/
+struct worker_stats {
+  volatile unsigned long long iterations;     /**CPU bound loop iterations.*/
+  volatile unsigned long samples;             /**Interactive wake-ups measured.*/
+  unsigned long long late_ns[MAX_SAMPLES];    /**Wake-up lateness per sample.*/
+};
+
+static unsigned long long now_ns(void) {
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**Registering the calling process with the custom scheduler.*/
+static void register_self(void) {
+
+  FILE *fp = fopen(PROC_FILE, "w");
+  if (fp == NULL) {
+    perror("fopen " PROC_FILE);
+    exit(1);
+  }
+  fprintf(fp, "%d", getpid());
+  fclose(fp);
+}
+
+/**CPU bound worker, spinning and counting until killed.*/
+static void cpu_worker(struct worker_stats *st) {
+
+  register_self();
+  while (1) {
+    st->iterations++;
+  }
+}
+
+/**Interactive worker, sleeping and recording the wake-up lateness until killed.*/
+static void io_worker(struct worker_stats *st, unsigned int sleep_us) {
+
+  register_self();
+  while (1) {
+    unsigned long long t0 = now_ns(), late;
+    usleep(sleep_us);
+    late = now_ns() - t0 - (unsigned long long)sleep_us * 1000ULL;
+    if (st->samples < MAX_SAMPLES) {
+      st->late_ns[st->samples] = late;
+      st->samples++;
+    }
+  }
+}
+
+static int cmp_ull(const void *a, const void *b) {
+
+  unsigned long long x = *(const unsigned long long *)a;
+  unsigned long long y = *(const unsigned long long *)b;
+  return x < y ? -1 : x > y;
+}
+
+int main(int argc, char *argv[]) {
+
+  int cpu_workers = argc > 1 ? atoi(argv[1]) : DEF_CPU_WORKERS;
+  int io_workers = argc > 2 ? atoi(argv[2]) : DEF_IO_WORKERS;
+  int seconds = argc > 3 ? atoi(argv[3]) : DEF_SECONDS;
+  int sleep_us = argc > 4 ? atoi(argv[4]) : DEF_SLEEP_US;
+  int workers = cpu_workers + io_workers;
+  struct worker_stats *stats;
+  pid_t pids[MAX_WORKERS];
+  unsigned long long iterations = 0, *late;
+  unsigned long samples = 0, n;
+  double total_late = 0.0;
+  int i;
+
+  if (cpu_workers < 0 || io_workers < 0 || workers < 1 || workers > MAX_WORKERS || seconds < 1 || sleep_us < 1) {
+    fprintf(stderr, "usage: %s [cpu_workers] [io_workers] [seconds] [sleep_us] (workers<=%d)\n", argv[0], MAX_WORKERS);
+    return 1;
+  }
+
+  stats = mmap(NULL, sizeof(*stats) * workers, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (stats == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+
+  for (i = 0; i < workers; i++) {
+    pids[i] = fork();
+    if (pids[i] == 0) {
+      if (i < cpu_workers) {
+        cpu_worker(&stats[i]);
+      }
+      else {
+        io_worker(&stats[i], sleep_us);
+      }
+    }
+  }
+  sleep(seconds);
+
+  for (i = 0; i < workers; i++) {
+    kill(pids[i], SIGKILL);
+    waitpid(pids[i], NULL, 0);
+  }
+
+  for (i = 0; i < workers; i++) {
+    iterations += stats[i].iterations;
+    samples += stats[i].samples;
+  }
+  late = malloc(sizeof(*late) * (samples ? samples : 1));
+  if (late == NULL) {
+    perror("malloc");
+    return 1;
+  }
+  for (i = cpu_workers, n = 0; i < workers; i++) {
+    unsigned long j;
+    for (j = 0; j < stats[i].samples; j++) {
+      late[n++] = stats[i].late_ns[j];
+      total_late += stats[i].late_ns[j];
+    }
+  }
+  qsort(late, samples, sizeof(*late), cmp_ull);
+
+  printf("cpu_workers=%d io_workers=%d seconds=%d sleep_us=%d\n", cpu_workers, io_workers, seconds, sleep_us);
+  printf("cpu iterations/s: %.0f\n", (double)iterations / seconds);
+  printf("io wake-ups: %lu\n", samples);
+  if (samples) {
+    printf("avg wake-up lateness: %.1f us\n", total_late / samples / 1000.0);
+    printf("p99 wake-up lateness: %.1f us\n", (double)late[(samples * 99) / 100] / 1000.0);
+    printf("max wake-up lateness: %.1f us\n", (double)late[samples - 1] / 1000.0);
+  }
+  free(late);
+  munmap(stats, sizeof(*stats) * workers);
+  return 0;
+}
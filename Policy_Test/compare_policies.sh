@@ -0,0 +1,22 @@
+# Runs bench_policy.out once per scheduling policy of process_scheduler.ko.
+# Expects the modules to be built and loaded (make load), arguments are
+# passed through to bench_policy.out.
+cd "$(dirname "$0")"
+sudo rmmod process_set.ko
+sudo rmmod policy_stride.ko
+sudo rmmod policy_mlfq.ko
+sudo rmmod policy_edf.ko
+sudo rmmod policy_fair.ko
+sudo rmmod process_scheduler.ko
+sudo insmod ../scheduler/process_scheduler.ko time_quantum_us=10000
+sudo insmod ../scheduler/policy_fair.ko
+sudo insmod ../scheduler/policy_edf.ko
+sudo insmod ../scheduler/policy_mlfq.ko
+sudo insmod ../scheduler/policy_stride.ko
+sudo insmod ../scheduler/process_set.ko
+for policy in static_rr dynamic_rr fair mlfq stride lottery
+do
+	echo $policy | sudo tee /sys/module/process_scheduler/parameters/policy > /dev/null
+	echo "policy=$policy"
+	./bench_policy.out "$@"
+done
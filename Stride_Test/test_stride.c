@@ -0,0 +1,244 @@
+/**
+  \file : test_stride.c
+  \author :   Sreeram Sadasivam
+  \brief  : Share drift test for the stride and lottery policies. Registers
+            one CPU bound worker per ticket count given, all pinned to the
+            same CPU so that they compete, runs for the given number of
+            scheduler quanta, read from the process_scheduler parameters,
+            and samples the CPU time and the CPU of every worker several
+            times per quantum. It reports how far the share of the CPU of
+            every worker drifts from the target share, its tickets over the
+            tickets of the workers sharing its CPU.
+
+            Select the policy first, e.g.
+            echo stride > /sys/module/process_scheduler/parameters/policy
+
+            Usage: ./test_stride.out [quanta] [cpu] [tickets...]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/**Macros*/
+#define PROC_FILE       "/proc/process_sched_add"
+#define QUANTUM_PARAM   "/sys/module/process_scheduler/parameters/time_quantum"
+#define QUANTUM_US_PARAM "/sys/module/process_scheduler/parameters/time_quantum_us"
+#define DEF_QUANTA      20
+#define DEF_CPU         0
+#define MAX_WORKERS     64
+/**Samples taken per scheduler quantum.*/
+#define SAMPLES_PER_QUANTUM 4
+/**Quanta ignored before the drift is tracked, every worker must have run once.*/
+#define WARMUP_QUANTA   4
+
+/**State of one worker.*/
+struct worker {
+  pid_t pid;
+  unsigned int tickets;
+  int cpu;                        /**CPU the worker last ran on, sampled with its CPU time.*/
+  unsigned long long start_ns;    /**CPU time at the start of the measurement.*/
+  unsigned long long used_ns;     /**CPU time received since the start.*/
+  double max_drift;               /**Largest drift seen after the warm up.*/
+};
+
+/**Worker registering itself with its tickets on the given CPU and spinning until killed.*/
+static void spin_worker(unsigned int tickets, int cpu) {
+
+  volatile unsigned long spin = 0;
+  FILE *fp = fopen(PROC_FILE, "w");
+  if (fp == NULL) {
+    perror("fopen " PROC_FILE);
+    exit(1);
+  }
+  fprintf(fp, "%d tickets=%u cpu=%d", getpid(), tickets, cpu);
+  if (fclose(fp) != 0) {
+    perror("register");
+    exit(1);
+  }
+  while (1) {
+    spin++;
+  }
+}
+
+/**Value of a numeric module parameter, 0 if it cannot be read.*/
+static unsigned long read_param(const char *path) {
+
+  unsigned long val = 0;
+  FILE *fp = fopen(path, "r");
+
+  if (fp != NULL) {
+    if (fscanf(fp, "%lu", &val) != 1) {
+      val = 0;
+    }
+    fclose(fp);
+  }
+  return val;
+}
+
+/**Scheduler quantum in microseconds, time_quantum_us overriding time_quantum.*/
+static unsigned long quantum_us(void) {
+
+  unsigned long us = read_param(QUANTUM_US_PARAM);
+
+  return us != 0 ? us : read_param(QUANTUM_PARAM) * 1000000UL;
+}
+
+/**CPU time of a process in nanoseconds, from /proc/<pid>/schedstat.*/
+static unsigned long long cputime_ns(pid_t pid) {
+
+  char path[64];
+  unsigned long long ns = 0;
+  FILE *fp;
+
+  snprintf(path, sizeof(path), "/proc/%d/schedstat", pid);
+  fp = fopen(path, "r");
+  if (fp != NULL) {
+    if (fscanf(fp, "%llu", &ns) != 1) {
+      ns = 0;
+    }
+    fclose(fp);
+  }
+  return ns;
+}
+
+/**CPU a process last ran on, field 39 of /proc/<pid>/stat.*/
+static int last_cpu(pid_t pid) {
+
+  char path[64], buf[1024], *p;
+  int field, cpu = -1;
+  FILE *fp;
+
+  snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+  fp = fopen(path, "r");
+  if (fp == NULL) {
+    return -1;
+  }
+  if (fgets(buf, sizeof(buf), fp) != NULL) {
+    /**Skipping past the command name, which may hold spaces.*/
+    p = strrchr(buf, ')');
+    for (field = 2; p != NULL && field < 39; field++) {
+      p = strchr(p + 1, ' ');
+    }
+    if (p != NULL) {
+      cpu = atoi(p + 1);
+    }
+  }
+  fclose(fp);
+  return cpu;
+}
+
+/**Target share of a worker among the workers of its CPU.*/
+static double target_share(struct worker *w, int n, int i) {
+
+  unsigned long long sum = 0;
+  int j;
+
+  for (j = 0; j < n; j++) {
+    if (w[j].cpu == w[i].cpu) {
+      sum += w[j].tickets;
+    }
+  }
+  return (double)w[i].tickets / sum;
+}
+
+/**Received share of a worker among the workers of its CPU.*/
+static double actual_share(struct worker *w, int n, int i) {
+
+  unsigned long long sum = 0;
+  int j;
+
+  for (j = 0; j < n; j++) {
+    if (w[j].cpu == w[i].cpu) {
+      sum += w[j].used_ns;
+    }
+  }
+  return sum ? (double)w[i].used_ns / sum : 0.0;
+}
+
+int main(int argc, char *argv[]) {
+
+  static const unsigned int def_tickets[] = { 50, 30, 20 };
+  int quanta = argc > 1 ? atoi(argv[1]) : DEF_QUANTA;
+  int cpu = argc > 2 ? atoi(argv[2]) : DEF_CPU;
+  int n = argc > 3 ? argc - 3 : 3;
+  unsigned long sample_us = quantum_us() / SAMPLES_PER_QUANTUM;
+  struct worker w[MAX_WORKERS] = {{0}};
+  double drift, max_drift = 0.0;
+  int i, s, c, moves = 0;
+
+  if (quanta <= WARMUP_QUANTA || cpu < 0 || n < 2 || n > MAX_WORKERS) {
+    fprintf(stderr, "usage: %s [quanta>%d] [cpu] [tickets...] (2<=workers<=%d)\n", argv[0], WARMUP_QUANTA, MAX_WORKERS);
+    return 1;
+  }
+  if (sample_us == 0) {
+    fprintf(stderr, "cannot read the quantum from " QUANTUM_PARAM ", is process_scheduler loaded?\n");
+    return 1;
+  }
+  for (i = 0; i < n; i++) {
+    w[i].tickets = argc > 3 ? (unsigned int)atoi(argv[i + 3]) : def_tickets[i];
+    if (w[i].tickets == 0) {
+      fprintf(stderr, "tickets must be positive\n");
+      return 1;
+    }
+  }
+
+  for (i = 0; i < n; i++) {
+    w[i].pid = fork();
+    if (w[i].pid == 0) {
+      spin_worker(w[i].tickets, cpu);
+    }
+  }
+  /**Letting the registrations settle.*/
+  sleep(1);
+  for (i = 0; i < n; i++) {
+    w[i].cpu = last_cpu(w[i].pid);
+    w[i].start_ns = cputime_ns(w[i].pid);
+  }
+
+  /**Sampling several times per quantum, the shares only move at the switches.*/
+  for (s = 1; s <= quanta * SAMPLES_PER_QUANTUM; s++) {
+    usleep(sample_us);
+    for (i = 0; i < n; i++) {
+      w[i].used_ns = cputime_ns(w[i].pid) - w[i].start_ns;
+      /**A worker moved by a steal competes with other workers from now on.*/
+      c = last_cpu(w[i].pid);
+      if (c != w[i].cpu) {
+        w[i].cpu = c;
+        moves++;
+      }
+    }
+    if (s <= WARMUP_QUANTA * SAMPLES_PER_QUANTUM) {
+      continue;
+    }
+    for (i = 0; i < n; i++) {
+      drift = fabs(actual_share(w, n, i) - target_share(w, n, i));
+      if (drift > w[i].max_drift) {
+        w[i].max_drift = drift;
+      }
+    }
+  }
+
+  for (i = 0; i < n; i++) {
+    kill(w[i].pid, SIGKILL);
+    waitpid(w[i].pid, NULL, 0);
+  }
+
+  printf("quanta=%d quantum_us=%lu cpu=%d workers=%d moves=%d\n", quanta, sample_us * SAMPLES_PER_QUANTUM, cpu, n, moves);
+  printf("%8s %4s %8s %9s %9s %9s %9s\n", "pid", "cpu", "tickets", "target%", "actual%", "drift%", "maxdrift%");
+  for (i = 0; i < n; i++) {
+    drift = fabs(actual_share(w, n, i) - target_share(w, n, i));
+    printf("%8d %4d %8u %9.2f %9.2f %9.2f %9.2f\n", w[i].pid, w[i].cpu, w[i].tickets,
+           100.0 * target_share(w, n, i), 100.0 * actual_share(w, n, i), 100.0 * drift, 100.0 * w[i].max_drift);
+    if (w[i].max_drift > max_drift) {
+      max_drift = w[i].max_drift;
+    }
+  }
+  printf("max share drift after %d quanta: %.2f%%\n", WARMUP_QUANTA, 100.0 * max_drift);
+  return 0;
+}
@@ -1,4 +1,8 @@
 sudo insmod process_queue.ko
 sudo insmod process_scheduler.ko time_quantum=5
+sudo insmod policy_fair.ko
+sudo insmod policy_edf.ko
+sudo insmod policy_mlfq.ko
+sudo insmod policy_stride.ko
 sudo insmod process_set.ko
 
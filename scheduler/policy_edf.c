@@ -0,0 +1,480 @@
+/**
+	\file	:	policy_edf.c
+	\author	: 	Sreeram Sadasivam
+	\brief	:	Earliest Deadline First scheduling policy module. A process
+				registered with a (runtime, period, deadline) reservation gets
+				runtime of CPU time in every period, dispatched from a red
+				black tree ordered by absolute deadline. A process that spent
+				its runtime is throttled until its next period. The policy
+				admits a reservation only while the utilization of the
+				sub-queue of its group on the CPU stays within the share
+				of the limit the group is guaranteed by its weight, and
+				counts the deadlines missed.
+				Processes without a reservation run in FIFO order whenever
+				no reserved process is ready.
+*/
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/errno.h>
+#include <linux/kernel.h>
+#include <linux/list.h>
+#include <linux/rbtree.h>
+#include <linux/atomic.h>
+#include <linux/moduleparam.h>
+#include <linux/ktime.h>
+#include "sched_policy.h"
+
+MODULE_AUTHOR("Sreeram Sadasivam");
+MODULE_DESCRIPTION("Earliest Deadline First Scheduling Policy Module");
+MODULE_LICENSE("GPL");
+
+/**Macros*/
+/**Fixed point shift of the utilizations, 1 << EDF_BW_SHIFT is a full CPU.*/
+#define EDF_BW_SHIFT	20
+
+/** Per run queue data of the EDF policy. */
+struct edf_rq {
+
+	struct rb_root_cached ready;	/**Reserved processes with budget, ordered by deadline.*/
+	struct list_head throttled;		/**Reserved processes waiting for their next period.*/
+	struct list_head background;	/**Processes without a reservation, in FIFO order.*/
+	u64 bw;							/**Utilization admitted in the sub-queue, fixed point.*/
+};
+
+/**Utilization limit of a CPU in percent.*/
+static unsigned int max_util_pct = 95;
+
+/**Shortest slice handed out, in microseconds.*/
+static unsigned long min_slice_us = 100;
+
+/**Deadlines missed since the module was loaded, over all processes.*/
+static atomic_long_t edf_missed = ATOMIC_LONG_INIT(0);
+
+/**Function Prototypes for the EDF Policy*/
+static bool edf_is_reserved(struct proc *p);
+static u64 edf_task_bw(struct proc *p);
+static u64 edf_max_bw(struct proc_rq *rq);
+static void edf_start_job(struct proc *p, u64 now);
+static void edf_miss(struct proc *p);
+static void edf_insert_ready(struct edf_rq *erq, struct proc *p);
+static void edf_release_throttled(struct edf_rq *erq, u64 now);
+static void edf_enqueue(struct proc_rq *rq, struct proc *p);
+static void edf_dequeue(struct proc_rq *rq, struct proc *p);
+static struct proc *edf_pick_next(struct proc_rq *rq);
+static void edf_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns);
+static void edf_task_dead(struct proc_rq *rq, struct proc *p);
+static u64 edf_timeslice(struct proc_rq *rq, struct proc *curr);
+static void edf_init_rq(struct proc_rq *rq);
+static int edf_admit(struct proc_rq *rq, struct proc *p);
+static bool edf_can_migrate(struct proc_rq *rq, struct proc *p);
+static bool edf_check_preempt(struct proc_rq *rq, struct proc *curr, struct proc *p);
+
+/**
+	Function Name : edf_is_reserved
+	Function Type : Policy Helper
+	Description   : Method checks if the process was registered with a
+					reservation.
+*/
+static bool edf_is_reserved(struct proc *p)
+{
+	return p->attr.runtime_ns != 0;
+}
+
+/**
+	Function Name : edf_task_bw
+	Function Type : Policy Helper
+	Description   : Method returns the utilization of the reservation of
+					the process, runtime over period in fixed point.
+*/
+static u64 edf_task_bw(struct proc *p)
+{
+	if(!edf_is_reserved(p)) {
+		return 0;
+	}
+	return div64_u64(p->attr.runtime_ns << EDF_BW_SHIFT, p->attr.period_ns);
+}
+
+/**
+	Function Name : edf_max_bw
+	Function Type : Policy Helper
+	Description   : Method returns the utilization the sub-queue may admit,
+					max_util_pct of the CPU scaled by the weight of its
+					group over the weight of all groups, the share of the
+					CPU the group gets when every group competes for it.
+					The limits of the groups on a CPU thus add up to at
+					most max_util_pct.
+*/
+static u64 edf_max_bw(struct proc_rq *rq)
+{
+	u64 total = max(process_group_total_weight(), 1U);
+	u64 weight = min_t(u64, READ_ONCE(rq->group->weight), total);
+
+	return div64_u64(((u64)max_util_pct << EDF_BW_SHIFT) * weight, 100 * total);
+}
+
+/**
+	Function Name : edf_start_job
+	Function Type : Policy Helper
+	Description   : Method starts a new period of the process at the given
+					time, with a full budget.
+*/
+static void edf_start_job(struct proc *p, u64 now)
+{
+	p->se.release = now;
+	p->se.deadline = now + p->attr.deadline_ns;
+	p->se.budget_ns = p->attr.runtime_ns;
+	p->se.throttled = false;
+}
+
+/**
+	Function Name : edf_miss
+	Function Type : Policy Helper
+	Description   : Method accounts a missed deadline of the process.
+*/
+static void edf_miss(struct proc *p)
+{
+	p->se.nr_missed++;
+	atomic_long_inc(&edf_missed);
+	pr_debug("EDF Policy: Process %d missed its deadline, %lu missed so far\n", p->pid, p->se.nr_missed);
+}
+
+/**
+	Function Name : edf_insert_ready
+	Function Type : Policy Helper
+	Description   : Method links a reserved process in the ready tree by
+					its absolute deadline. O(log n).
+*/
+static void edf_insert_ready(struct edf_rq *erq, struct proc *p)
+{
+	struct rb_node **link = &erq->ready.rb_root.rb_node, *parent = NULL;
+	bool leftmost = true;
+
+	/**Walking down to the insertion point, equal deadlines go right.*/
+	while(*link != NULL) {
+		parent = *link;
+		if((s64)(p->se.deadline - rb_entry(parent, struct proc, se.run_node)->se.deadline) < 0) {
+			link = &parent->rb_left;
+		}
+		else {
+			link = &parent->rb_right;
+			leftmost = false;
+		}
+	}
+	rb_link_node(&p->se.run_node, parent, link);
+	rb_insert_color_cached(&p->se.run_node, &erq->ready, leftmost);
+}
+
+/**
+	Function Name : edf_release_throttled
+	Function Type : Policy Helper
+	Description   : Method moves the throttled processes whose next period
+					has started to the ready tree. Linear in the number of
+					throttled processes.
+*/
+static void edf_release_throttled(struct edf_rq *erq, u64 now)
+{
+	struct proc *p, *tmp;
+
+	list_for_each_entry_safe(p, tmp, &erq->throttled, se.run_list) {
+		if((s64)(now - p->se.release) >= 0) {
+			list_del_init(&p->se.run_list);
+			p->se.throttled = false;
+			edf_insert_ready(erq, p);
+		}
+	}
+}
+
+/**
+	Function Name : edf_enqueue
+	Function Type : Policy Hook
+	Description   : Enqueue hook. A reserved process goes to the ready tree,
+					or to the throttled list until its period starts. The
+					others wait in FIFO order.
+*/
+static void edf_enqueue(struct proc_rq *rq, struct proc *p)
+{
+	struct edf_rq *erq = rq->policy_priv;
+
+	if(!edf_is_reserved(p)) {
+		list_add_tail(&p->se.run_list, &erq->background);
+	}
+	else if(p->se.throttled) {
+		list_add_tail(&p->se.run_list, &erq->throttled);
+	}
+	else {
+		edf_insert_ready(erq, p);
+	}
+}
+
+/**
+	Function Name : edf_dequeue
+	Function Type : Policy Hook
+	Description   : Dequeue hook, from whichever structure holds the process.
+*/
+static void edf_dequeue(struct proc_rq *rq, struct proc *p)
+{
+	struct edf_rq *erq = rq->policy_priv;
+
+	if(!RB_EMPTY_NODE(&p->se.run_node)) {
+		rb_erase_cached(&p->se.run_node, &erq->ready);
+		RB_CLEAR_NODE(&p->se.run_node);
+	}
+	else {
+		list_del_init(&p->se.run_list);
+	}
+}
+
+/**
+	Function Name : edf_pick_next
+	Function Type : Policy Hook
+	Description   : Pick next hook, the ready reserved process with the
+					earliest deadline, else the oldest process without a
+					reservation.
+*/
+static struct proc *edf_pick_next(struct proc_rq *rq)
+{
+	struct edf_rq *erq = rq->policy_priv;
+	struct rb_node *leftmost;
+
+	edf_release_throttled(erq, ktime_get_ns());
+	leftmost = rb_first_cached(&erq->ready);
+	if(leftmost != NULL) {
+		return rb_entry(leftmost, struct proc, se.run_node);
+	}
+	return list_first_entry_or_null(&erq->background, struct proc, se.run_list);
+}
+
+/**
+	Function Name : edf_tick
+	Function Type : Policy Hook
+	Description   : Tick hook, charges the CPU time of the slice to the
+					budget of a reserved process. A job that spent its
+					budget after its deadline, or that is still running at
+					its deadline, missed it. A spent budget throttles the
+					process until its next period, a late job restarts its
+					period now.
+*/
+static void edf_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns)
+{
+	u64 now = ktime_get_ns();
+
+	if(!edf_is_reserved(p)) {
+		return;
+	}
+	p->se.budget_ns -= min(ran_ns, p->se.budget_ns);
+	if(p->se.budget_ns == 0) {
+		if((s64)(now - p->se.deadline) > 0) {
+			edf_miss(p);
+		}
+		/**Waiting for the next period on the grid, or for now if behind it.*/
+		p->se.release += p->attr.period_ns;
+		if((s64)(now - p->se.release) > 0) {
+			p->se.release = now;
+		}
+		p->se.deadline = p->se.release + p->attr.deadline_ns;
+		p->se.budget_ns = p->attr.runtime_ns;
+		p->se.throttled = (s64)(p->se.release - now) > 0;
+	}
+	else if((s64)(now - p->se.deadline) > 0) {
+		edf_miss(p);
+		edf_start_job(p, now);
+	}
+}
+
+/**
+	Function Name : edf_task_dead
+	Function Type : Policy Hook
+	Description   : Task dead hook, gives the reservation back.
+*/
+static void edf_task_dead(struct proc_rq *rq, struct proc *p)
+{
+	struct edf_rq *erq = rq->policy_priv;
+
+	erq->bw -= min(edf_task_bw(p), erq->bw);
+}
+
+/**
+	Function Name : edf_timeslice
+	Function Type : Policy Hook
+	Description   : Time slice hook. A reserved process runs until its
+					budget is spent. Any process is cut at the start of the
+					next throttled period, so that a released job is not
+					kept waiting for the default quantum.
+*/
+static u64 edf_timeslice(struct proc_rq *rq, struct proc *curr)
+{
+	struct edf_rq *erq = rq->policy_priv;
+	struct proc *p;
+	u64 now = ktime_get_ns(), slice_ns = U64_MAX;
+
+	if(curr != NULL && edf_is_reserved(curr)) {
+		slice_ns = curr->se.budget_ns;
+	}
+	list_for_each_entry(p, &erq->throttled, se.run_list) {
+		slice_ns = min(slice_ns, (s64)(p->se.release - now) > 0 ? p->se.release - now : 0);
+	}
+	if(slice_ns == U64_MAX) {
+		/**Nothing bounds the slice, the default quantum.*/
+		return 0;
+	}
+	return max(slice_ns, (u64)min_slice_us * NSEC_PER_USEC);
+}
+
+/**
+	Function Name : edf_init_rq
+	Function Type : Policy Hook
+	Description   : Init hook. Every reserved process of the run queue
+					starts a new period now and its utilization is counted.
+					The processes are already registered and cannot be
+					turned down, a group over its share is only reported.
+*/
+static void edf_init_rq(struct proc_rq *rq)
+{
+	struct edf_rq *erq = rq->policy_priv;
+	struct proc *p;
+	u64 now = ktime_get_ns();
+
+	erq->ready = RB_ROOT_CACHED;
+	INIT_LIST_HEAD(&erq->throttled);
+	INIT_LIST_HEAD(&erq->background);
+	erq->bw = 0;
+	list_for_each_entry(p, &(rq->top.list), list) {
+		if(edf_is_reserved(p)) {
+			edf_start_job(p, now);
+			erq->bw += edf_task_bw(p);
+		}
+	}
+	if(erq->bw > edf_max_bw(rq)) {
+		printk(KERN_ALERT "EDF Policy ERROR:group %s is over its share of CPU %d, deadlines will be missed.\n", rq->group->name, rq->cpu);
+	}
+}
+
+/**
+	Function Name : edf_admit
+	Function Type : Policy Hook
+	Description   : Admit hook, accepts a reservation only while the
+					utilization of the run queue stays within the share of
+					max_util_pct of its group, see edf_max_bw. As the groups
+					of a CPU are served in proportion to their weights,
+					this keeps every deadline equal to its period whatever
+					the other groups run, up to the granularity of the
+					group switches. A group added or reweighted later
+					shrinks the share the earlier reservations rely on.
+*/
+static int edf_admit(struct proc_rq *rq, struct proc *p)
+{
+	struct edf_rq *erq = rq->policy_priv;
+	u64 bw = edf_task_bw(p);
+
+	if(!edf_is_reserved(p)) {
+		return 0;
+	}
+	if(erq->bw + bw > edf_max_bw(rq)) {
+		return -EBUSY;
+	}
+	erq->bw += bw;
+	edf_start_job(p, ktime_get_ns());
+	return 0;
+}
+
+/**
+	Function Name : edf_can_migrate
+	Function Type : Policy Hook
+	Description   : Can migrate hook, a reservation stays on the CPU that
+					admitted it.
+*/
+static bool edf_can_migrate(struct proc_rq *rq, struct proc *p)
+{
+	return !edf_is_reserved(p);
+}
+
+/**
+	Function Name : edf_check_preempt
+	Function Type : Policy Hook
+	Description   : Preemption hook, a ready reservation takes the CPU at
+					once from a process without one, or from a reservation
+					with a later deadline.
+*/
+static bool edf_check_preempt(struct proc_rq *rq, struct proc *curr, struct proc *p)
+{
+	if(!edf_is_reserved(p) || p->se.throttled) {
+		return false;
+	}
+	return !edf_is_reserved(curr) || (s64)(p->se.deadline - curr->se.deadline) < 0;
+}
+
+/**Earliest Deadline First policy.*/
+static struct sched_policy_ops edf_policy = {
+	.name			= "edf",
+	.owner			= THIS_MODULE,
+	.rq_priv_size	= sizeof(struct edf_rq),
+	.enqueue		= edf_enqueue,
+	.dequeue		= edf_dequeue,
+	.pick_next		= edf_pick_next,
+	.tick			= edf_tick,
+	.task_dead		= edf_task_dead,
+	.timeslice		= edf_timeslice,
+	.init_rq		= edf_init_rq,
+	.admit			= edf_admit,
+	.can_migrate	= edf_can_migrate,
+	.check_preempt	= edf_check_preempt,
+};
+
+/**
+	Function Name : missed_deadlines_get
+	Function Type : Module Parameter Callback
+	Description   : Method reports the deadlines missed over all processes
+			through /sys/module/policy_edf/parameters/missed_deadlines.
+*/
+static int missed_deadlines_get(char *buffer, const struct kernel_param *kp)
+{
+	return sprintf(buffer, "%ld\n", atomic_long_read(&edf_missed));
+}
+
+/** Read only parameter operations for the missed deadline counter. */
+static const struct kernel_param_ops missed_deadlines_ops = {
+	.get =	missed_deadlines_get,
+};
+
+/**
+	Function Name : policy_edf_module_init
+	Function Type : Module INIT
+	Description   : Initialization method of the Kernel module. The
+			method gets invoked when the kernel module is being
+			inserted using the command insmod.
+*/
+static int __init policy_edf_module_init(void)
+{
+	printk(KERN_INFO "EDF Policy module is being loaded.\n");
+
+	if(max_util_pct == 0 || max_util_pct > 100 || min_slice_us == 0) {
+		printk(KERN_ERR "EDF Policy ERROR:max_util_pct must be within 1..100 and min_slice_us positive\n");
+		return -EINVAL;
+	}
+	/**Making the policy selectable, it is installed once selected.*/
+	return register_sched_policy(&edf_policy);
+}
+
+/**
+	Function Name : policy_edf_module_cleanup
+	Function Type : Module EXIT
+	Description   : Cleanup method of the Kernel module. The
+                	method gets invoked when the kernel module is being
+                 	removed using the command rmmod.
+*/
+static void __exit policy_edf_module_cleanup(void)
+{
+	printk(KERN_INFO "EDF Policy module is being unloaded.\n");
+	unregister_sched_policy(&edf_policy);
+}
+
+/** Initializing the kernel module init with custom init method */
+module_init(policy_edf_module_init);
+/** Initializing the kernel module exit with custom cleanup method */
+module_exit(policy_edf_module_cleanup);
+
+/**Initializing the utilization limit and the minimum slice*/
+module_param(max_util_pct, uint, 0);
+module_param(min_slice_us, ulong, 0);
+/**Exposing the missed deadline counter as a read only parameter.*/
+module_param_cb(missed_deadlines, &missed_deadlines_ops, NULL, 0444);
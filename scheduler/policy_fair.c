@@ -0,0 +1,287 @@
+/**
+	\file	:	policy_fair.c
+	\author	: 	Sreeram Sadasivam
+	\brief	:	Fair share scheduling policy module. The waiting processes of a
+				run queue are ordered in a red black tree by their virtual
+				runtime, the CPU time they consumed scaled by the load weight
+				of their nice value. The process with the smallest virtual
+				runtime runs next, for a slice proportional to its weight.
+*/
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/errno.h>
+#include <linux/kernel.h>
+#include <linux/rbtree.h>
+#include <linux/moduleparam.h>
+#include <linux/sched.h>
+#include <linux/pid.h>
+#include <linux/rcupdate.h>
+#include "sched_policy.h"
+
+MODULE_AUTHOR("Sreeram Sadasivam");
+MODULE_DESCRIPTION("Fair Share Scheduling Policy Module");
+MODULE_LICENSE("GPL");
+
+/**Macros*/
+/**Load weight of nice 0, the unit of the virtual runtime.*/
+#define NICE_0_WEIGHT	1024
+/**Lowest nice value, index 0 of the weight table.*/
+#define FAIR_MIN_NICE	-20
+
+/**
+	Load weight of every nice value from -20 to 19, the table the Linux
+	scheduler uses. Each nice level is worth about 10% of CPU time.
+*/
+static const unsigned long nice_to_weight[40] = {
+	/* -20 */	88761,	71755,	56483,	46273,	36291,
+	/* -15 */	29154,	23254,	18705,	14949,	11916,
+	/* -10 */	9548,	7620,	6100,	4904,	3906,
+	/*  -5 */	3121,	2501,	1991,	1586,	1277,
+	/*   0 */	1024,	820,	655,	526,	423,
+	/*   5 */	335,	272,	215,	172,	137,
+	/*  10 */	110,	87,		70,		56,		45,
+	/*  15 */	36,		29,		23,		18,		15,
+};
+
+/** Per run queue data of the fair policy. */
+struct fair_rq {
+
+	struct rb_root_cached tasks;	/**Waiting processes ordered by virtual runtime.*/
+	u64 min_vruntime;				/**Monotonic floor of the virtual runtimes.*/
+	unsigned long load;				/**Sum of the weights of the waiting processes.*/
+};
+
+/**Period in which every waiting process runs once, in microseconds.*/
+static unsigned long sched_latency_us = 24000;
+
+/**Shortest slice handed out, in microseconds.*/
+static unsigned long min_granularity_us = 3000;
+
+/**Function Prototypes for the Fair Policy*/
+static unsigned long fair_task_weight(struct proc *p);
+static bool fair_vruntime_before(struct proc *a, struct proc *b);
+static void fair_update_min_vruntime(struct fair_rq *frq);
+static void fair_enqueue(struct proc_rq *rq, struct proc *p);
+static void fair_dequeue(struct proc_rq *rq, struct proc *p);
+static struct proc *fair_pick_next(struct proc_rq *rq);
+static void fair_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns);
+static u64 fair_timeslice(struct proc_rq *rq, struct proc *curr);
+static void fair_init_rq(struct proc_rq *rq);
+
+/**
+	Function Name : fair_task_weight
+	Function Type : Policy Helper
+	Description   : Method returns the load weight of the current nice value
+					of the task, the nice 0 weight if the task is gone.
+*/
+static unsigned long fair_task_weight(struct proc *p)
+{
+	struct task_struct *task;
+	int nice = 0;
+
+	rcu_read_lock();
+	task = pid_task(p->pid_ref, PIDTYPE_PID);
+	if(task != NULL) {
+		nice = task_nice(task);
+	}
+	rcu_read_unlock();
+	return nice_to_weight[nice - FAIR_MIN_NICE];
+}
+
+/**
+	Function Name : fair_vruntime_before
+	Function Type : Policy Helper
+	Description   : Method orders two processes by virtual runtime, the
+					comparison is wrap safe.
+*/
+static bool fair_vruntime_before(struct proc *a, struct proc *b)
+{
+	return (s64)(a->se.vruntime - b->se.vruntime) < 0;
+}
+
+/**
+	Function Name : fair_update_min_vruntime
+	Function Type : Policy Helper
+	Description   : Method moves the floor of the virtual runtimes up to the
+					leftmost waiting process. The floor never goes back.
+*/
+static void fair_update_min_vruntime(struct fair_rq *frq)
+{
+	struct rb_node *leftmost = rb_first_cached(&frq->tasks);
+	struct proc *p;
+
+	if(leftmost != NULL) {
+		p = rb_entry(leftmost, struct proc, se.run_node);
+		if((s64)(p->se.vruntime - frq->min_vruntime) > 0) {
+			frq->min_vruntime = p->se.vruntime;
+		}
+	}
+}
+
+/**
+	Function Name : fair_enqueue
+	Function Type : Policy Hook
+	Description   : Enqueue hook. Off the tree the virtual runtime is kept
+					relative to the floor of the run queue it left, so a new
+					process starts at the floor and a stolen one keeps its
+					lag on its new run queue. The weight is read again from
+					the nice value, renicing takes effect here. O(log n).
+*/
+static void fair_enqueue(struct proc_rq *rq, struct proc *p)
+{
+	struct fair_rq *frq = rq->policy_priv;
+	struct rb_node **link = &frq->tasks.rb_root.rb_node, *parent = NULL;
+	bool leftmost = true;
+
+	p->se.weight = fair_task_weight(p);
+	p->se.vruntime += frq->min_vruntime;
+	/**Walking down to the insertion point, equal keys go right.*/
+	while(*link != NULL) {
+		parent = *link;
+		if(fair_vruntime_before(p, rb_entry(parent, struct proc, se.run_node))) {
+			link = &parent->rb_left;
+		}
+		else {
+			link = &parent->rb_right;
+			leftmost = false;
+		}
+	}
+	rb_link_node(&p->se.run_node, parent, link);
+	rb_insert_color_cached(&p->se.run_node, &frq->tasks, leftmost);
+	frq->load += p->se.weight;
+	fair_update_min_vruntime(frq);
+}
+
+/**
+	Function Name : fair_dequeue
+	Function Type : Policy Hook
+	Description   : Dequeue hook, the virtual runtime becomes relative to
+					the floor again. O(log n).
+*/
+static void fair_dequeue(struct proc_rq *rq, struct proc *p)
+{
+	struct fair_rq *frq = rq->policy_priv;
+
+	rb_erase_cached(&p->se.run_node, &frq->tasks);
+	RB_CLEAR_NODE(&p->se.run_node);
+	frq->load -= p->se.weight;
+	fair_update_min_vruntime(frq);
+	p->se.vruntime -= frq->min_vruntime;
+}
+
+/**
+	Function Name : fair_pick_next
+	Function Type : Policy Hook
+	Description   : Pick next hook, the process with the smallest virtual
+					runtime. O(1), the leftmost node is cached.
+*/
+static struct proc *fair_pick_next(struct proc_rq *rq)
+{
+	struct fair_rq *frq = rq->policy_priv;
+
+	return rb_entry_safe(rb_first_cached(&frq->tasks), struct proc, se.run_node);
+}
+
+/**
+	Function Name : fair_tick
+	Function Type : Policy Hook
+	Description   : Tick hook, charges the CPU time of the slice scaled by
+					the inverse of the weight, a heavier process ages slower.
+*/
+static void fair_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns)
+{
+	p->se.vruntime += div_u64(ran_ns * NICE_0_WEIGHT, p->se.weight);
+}
+
+/**
+	Function Name : fair_timeslice
+	Function Type : Policy Hook
+	Description   : Time slice hook, the running process gets its weighted
+					share of the latency period, at least the minimum
+					granularity.
+*/
+static u64 fair_timeslice(struct proc_rq *rq, struct proc *curr)
+{
+	struct fair_rq *frq = rq->policy_priv;
+	u64 slice_ns, min_ns = (u64)min_granularity_us * NSEC_PER_USEC;
+
+	if(curr == NULL) {
+		/**Nothing runs, the default quantum.*/
+		return 0;
+	}
+	slice_ns = div64_u64((u64)sched_latency_us * NSEC_PER_USEC * curr->se.weight, frq->load + curr->se.weight);
+	return max(slice_ns, min_ns);
+}
+
+/**
+	Function Name : fair_init_rq
+	Function Type : Policy Hook
+	Description   : Init hook, an empty tree. A process already running when
+					the policy is installed was never enqueued here and gets
+					its weight now, its slice ends through the tick hook.
+*/
+static void fair_init_rq(struct proc_rq *rq)
+{
+	struct fair_rq *frq = rq->policy_priv;
+
+	frq->tasks = RB_ROOT_CACHED;
+	frq->min_vruntime = 0;
+	frq->load = 0;
+	if(rq->curr != NULL) {
+		rq->curr->se.weight = fair_task_weight(rq->curr);
+	}
+}
+
+/**Fair share policy.*/
+static struct sched_policy_ops fair_policy = {
+	.name			= "fair",
+	.owner			= THIS_MODULE,
+	.rq_priv_size	= sizeof(struct fair_rq),
+	.enqueue		= fair_enqueue,
+	.dequeue		= fair_dequeue,
+	.pick_next		= fair_pick_next,
+	.tick			= fair_tick,
+	.timeslice		= fair_timeslice,
+	.init_rq		= fair_init_rq,
+};
+
+/**
+	Function Name : policy_fair_module_init
+	Function Type : Module INIT
+	Description   : Initialization method of the Kernel module. The
+			method gets invoked when the kernel module is being
+			inserted using the command insmod.
+*/
+static int __init policy_fair_module_init(void)
+{
+	printk(KERN_INFO "Fair Share Policy module is being loaded.\n");
+
+	if(sched_latency_us == 0 || min_granularity_us == 0) {
+		printk(KERN_ERR "Fair Share Policy ERROR:sched_latency_us and min_granularity_us must be positive\n");
+		return -EINVAL;
+	}
+	/**Making the policy selectable, it is installed once selected.*/
+	return register_sched_policy(&fair_policy);
+}
+
+/**
+	Function Name : policy_fair_module_cleanup
+	Function Type : Module EXIT
+	Description   : Cleanup method of the Kernel module. The
+                	method gets invoked when the kernel module is being
+                 	removed using the command rmmod.
+*/
+static void __exit policy_fair_module_cleanup(void)
+{
+	printk(KERN_INFO "Fair Share Policy module is being unloaded.\n");
+	unregister_sched_policy(&fair_policy);
+}
+
+/** Initializing the kernel module init with custom init method */
+module_init(policy_fair_module_init);
+/** Initializing the kernel module exit with custom cleanup method */
+module_exit(policy_fair_module_cleanup);
+
+/**Initializing the latency period and the minimum granularity*/
+module_param(sched_latency_us, ulong, 0);
+module_param(min_granularity_us, ulong, 0);
@@ -0,0 +1,277 @@
+/**
+	\file	:	policy_mlfq.c
+	\author	: 	Sreeram Sadasivam
+	\brief	:	Multi level feedback queue scheduling policy module. Every run
+				queue keeps one FIFO per priority level, the lower levels with
+				the longer slices. Each time a process leaves the Running
+				state the CPU time it used is added to its allotment at
+				its level. A process whose allotment reaches the slice of
+				its level is CPU bound and goes one level down, whether it
+				used it in one slice or over many cut short. One that went
+				to sleep early in its slice is interactive and goes one
+				level up. Every boost interval all processes return to the
+				top level, so none starves.
+*/
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/errno.h>
+#include <linux/kernel.h>
+#include <linux/list.h>
+#include <linux/bitops.h>
+#include <linux/moduleparam.h>
+#include <linux/ktime.h>
+#include "sched_policy.h"
+
+MODULE_AUTHOR("Sreeram Sadasivam");
+MODULE_DESCRIPTION("Multi Level Feedback Queue Scheduling Policy Module");
+MODULE_LICENSE("GPL");
+
+/**Macros*/
+/**Number of priority levels, level 0 the highest.*/
+#define MLFQ_LEVELS		4
+
+/** Per run queue data of the MLFQ policy. */
+struct mlfq_rq {
+
+	struct list_head levels[MLFQ_LEVELS];	/**Waiting processes of every level, in FIFO order.*/
+	unsigned long active;					/**Bit i set while level i has waiting processes.*/
+	u64 last_boost_ns;						/**Time of the last boost.*/
+};
+
+/**Slice of the top level in microseconds, every level below doubles it.*/
+static unsigned long base_slice_us = 10000;
+
+/**Interval of the boosts to the top level in microseconds.*/
+static unsigned long boost_interval_us = 1000000;
+
+/**Share of its slice in percent a process must use to be demoted.*/
+static unsigned int demote_pct = 80;
+
+/**Share of its slice in percent below which a process is promoted.*/
+static unsigned int promote_pct = 20;
+
+/**Function Prototypes for the MLFQ Policy*/
+static u64 mlfq_level_slice(unsigned int level);
+static void mlfq_boost(struct proc_rq *rq, u64 now);
+static void mlfq_enqueue(struct proc_rq *rq, struct proc *p);
+static void mlfq_dequeue(struct proc_rq *rq, struct proc *p);
+static struct proc *mlfq_pick_next(struct proc_rq *rq);
+static void mlfq_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns);
+static u64 mlfq_timeslice(struct proc_rq *rq, struct proc *curr);
+static void mlfq_init_rq(struct proc_rq *rq);
+static bool mlfq_check_preempt(struct proc_rq *rq, struct proc *curr, struct proc *p);
+
+/**
+	Function Name : mlfq_level_slice
+	Function Type : Policy Helper
+	Description   : Method returns the slice of a level in nanoseconds.
+*/
+static u64 mlfq_level_slice(unsigned int level)
+{
+	return ((u64)base_slice_us * NSEC_PER_USEC) << level;
+}
+
+/**
+	Function Name : mlfq_boost
+	Function Type : Policy Helper
+	Description   : Method moves every process of the run queue, the
+					running one included, to the top level. Linear in the
+					number of processes, done once per boost interval.
+*/
+static void mlfq_boost(struct proc_rq *rq, u64 now)
+{
+	struct mlfq_rq *mrq = rq->policy_priv;
+	struct proc *p;
+	unsigned int level;
+
+	list_for_each_entry(p, &(rq->top.list), list) {
+		p->se.level = 0;
+		p->se.allot_ns = 0;
+	}
+	for(level = 1; level < MLFQ_LEVELS; level++) {
+		list_splice_tail_init(&mrq->levels[level], &mrq->levels[0]);
+	}
+	mrq->active = list_empty(&mrq->levels[0]) ? 0 : BIT(0);
+	mrq->last_boost_ns = now;
+}
+
+/**
+	Function Name : mlfq_enqueue
+	Function Type : Policy Hook
+	Description   : Enqueue hook, the process waits at the tail of its level.
+*/
+static void mlfq_enqueue(struct proc_rq *rq, struct proc *p)
+{
+	struct mlfq_rq *mrq = rq->policy_priv;
+
+	list_add_tail(&p->se.run_list, &mrq->levels[p->se.level]);
+	__set_bit(p->se.level, &mrq->active);
+}
+
+/**
+	Function Name : mlfq_dequeue
+	Function Type : Policy Hook
+	Description   : Dequeue hook.
+*/
+static void mlfq_dequeue(struct proc_rq *rq, struct proc *p)
+{
+	struct mlfq_rq *mrq = rq->policy_priv;
+
+	list_del_init(&p->se.run_list);
+	if(list_empty(&mrq->levels[p->se.level])) {
+		__clear_bit(p->se.level, &mrq->active);
+	}
+}
+
+/**
+	Function Name : mlfq_pick_next
+	Function Type : Policy Hook
+	Description   : Pick next hook, the oldest process of the highest non
+					empty level, boosting first when the interval is over.
+					O(1) outside the boosts.
+*/
+static struct proc *mlfq_pick_next(struct proc_rq *rq)
+{
+	struct mlfq_rq *mrq = rq->policy_priv;
+	u64 now = ktime_get_ns();
+
+	if(now - mrq->last_boost_ns >= (u64)boost_interval_us * NSEC_PER_USEC) {
+		mlfq_boost(rq, now);
+	}
+	if(mrq->active == 0) {
+		return NULL;
+	}
+	return list_first_entry(&mrq->levels[__ffs(mrq->active)], struct proc, se.run_list);
+}
+
+/**
+	Function Name : mlfq_tick
+	Function Type : Policy Hook
+	Description   : Tick hook, classifies the process leaving the CPU. The
+					CPU time it used is charged to its allotment at its
+					level, so a process preempted before the end of each of
+					its slices is still demoted once it used the slice of
+					its level in total. Only a process that went to sleep
+					is promoted, a preempted one gave nothing up.
+*/
+static void mlfq_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns)
+{
+	u64 slice_ns = mlfq_level_slice(p->se.level);
+
+	p->se.allot_ns += ran_ns;
+	if(p->se.allot_ns * 100 >= slice_ns * demote_pct) {
+		/**CPU bound, one level down with a fresh allotment.*/
+		if(p->se.level < MLFQ_LEVELS - 1) {
+			p->se.level++;
+		}
+		p->se.allot_ns = 0;
+	}
+	else if(p->state == eBlocked && ran_ns * 100 < slice_ns * promote_pct) {
+		/**Interactive, one level up with a fresh allotment.*/
+		if(p->se.level > 0) {
+			p->se.level--;
+			p->se.allot_ns = 0;
+		}
+	}
+}
+
+/**
+	Function Name : mlfq_timeslice
+	Function Type : Policy Hook
+	Description   : Time slice hook, the slice of the level of the running
+					process.
+*/
+static u64 mlfq_timeslice(struct proc_rq *rq, struct proc *curr)
+{
+	if(curr == NULL) {
+		/**Nothing runs, the default quantum.*/
+		return 0;
+	}
+	return mlfq_level_slice(curr->se.level);
+}
+
+/**
+	Function Name : mlfq_init_rq
+	Function Type : Policy Hook
+	Description   : Init hook, empty levels, every process starts at the top.
+*/
+static void mlfq_init_rq(struct proc_rq *rq)
+{
+	struct mlfq_rq *mrq = rq->policy_priv;
+	unsigned int level;
+
+	for(level = 0; level < MLFQ_LEVELS; level++) {
+		INIT_LIST_HEAD(&mrq->levels[level]);
+	}
+	mlfq_boost(rq, ktime_get_ns());
+}
+
+/**
+	Function Name : mlfq_check_preempt
+	Function Type : Policy Hook
+	Description   : Preemption hook, a process of a higher level than the
+					running one takes the CPU at once. New and woken
+					processes, often at the top, do not wait for the slice
+					of a CPU bound one to end.
+*/
+static bool mlfq_check_preempt(struct proc_rq *rq, struct proc *curr, struct proc *p)
+{
+	return p->se.level < curr->se.level;
+}
+
+/**Multi level feedback queue policy.*/
+static struct sched_policy_ops mlfq_policy = {
+	.name			= "mlfq",
+	.owner			= THIS_MODULE,
+	.rq_priv_size	= sizeof(struct mlfq_rq),
+	.enqueue		= mlfq_enqueue,
+	.dequeue		= mlfq_dequeue,
+	.pick_next		= mlfq_pick_next,
+	.tick			= mlfq_tick,
+	.timeslice		= mlfq_timeslice,
+	.init_rq		= mlfq_init_rq,
+	.check_preempt	= mlfq_check_preempt,
+};
+
+/**
+	Function Name : policy_mlfq_module_init
+	Function Type : Module INIT
+	Description   : Initialization method of the Kernel module. The
+			method gets invoked when the kernel module is being
+			inserted using the command insmod.
+*/
+static int __init policy_mlfq_module_init(void)
+{
+	printk(KERN_INFO "MLFQ Policy module is being loaded.\n");
+
+	if(base_slice_us == 0 || boost_interval_us == 0 || promote_pct >= demote_pct || demote_pct > 100) {
+		printk(KERN_ERR "MLFQ Policy ERROR:invalid slice, boost interval or thresholds\n");
+		return -EINVAL;
+	}
+	/**Making the policy selectable, it is installed once selected.*/
+	return register_sched_policy(&mlfq_policy);
+}
+
+/**
+	Function Name : policy_mlfq_module_cleanup
+	Function Type : Module EXIT
+	Description   : Cleanup method of the Kernel module. The
+                	method gets invoked when the kernel module is being
+                 	removed using the command rmmod.
+*/
+static void __exit policy_mlfq_module_cleanup(void)
+{
+	printk(KERN_INFO "MLFQ Policy module is being unloaded.\n");
+	unregister_sched_policy(&mlfq_policy);
+}
+
+/** Initializing the kernel module init with custom init method */
+module_init(policy_mlfq_module_init);
+/** Initializing the kernel module exit with custom cleanup method */
+module_exit(policy_mlfq_module_cleanup);
+
+/**Initializing the slices, the boost interval and the thresholds*/
+module_param(base_slice_us, ulong, 0);
+module_param(boost_interval_us, ulong, 0);
+module_param(demote_pct, uint, 0);
+module_param(promote_pct, uint, 0);
@@ -0,0 +1,405 @@
+/**
+	\file	:	policy_stride.c
+	\author	: 	Sreeram Sadasivam
+	\brief	:	Proportional share scheduling policy module. Every process holds
+				a number of tickets, given at registration, and receives a
+				share of its CPU in proportion to them. Two policies are
+				registered. "stride" is deterministic: each process advances
+				a pass by the CPU time it used over its tickets and the lowest
+				pass runs next. "lottery" draws a random ticket on every
+				switch from a tree augmented with the ticket count of every
+				subtree. Both pick the next process in O(log n) at most.
+*/
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/errno.h>
+#include <linux/kernel.h>
+#include <linux/rbtree.h>
+#include <linux/rbtree_augmented.h>
+#include <linux/random.h>
+#include <linux/moduleparam.h>
+#include "sched_policy.h"
+
+MODULE_AUTHOR("Sreeram Sadasivam");
+MODULE_DESCRIPTION("Stride and Lottery Scheduling Policy Module");
+MODULE_LICENSE("GPL");
+
+/** Per run queue data of the stride policy. */
+struct stride_rq {
+
+	struct rb_root_cached tasks;	/**Waiting processes ordered by pass.*/
+	u64 global_pass;				/**Monotonic floor of the passes.*/
+};
+
+/** Per run queue data of the lottery policy. */
+struct lottery_rq {
+
+	struct rb_root tasks;			/**Waiting processes ordered by pid, augmented with ticket sums.*/
+};
+
+/**Tickets of a process registered without a ticket count.*/
+static unsigned int default_tickets = SCHED_TICKETS_DEFAULT;
+
+/**Function Prototypes for the Stride and Lottery Policies*/
+static unsigned int share_tickets(struct proc *p);
+static void stride_update_global_pass(struct stride_rq *srq);
+static void stride_enqueue(struct proc_rq *rq, struct proc *p);
+static void stride_dequeue(struct proc_rq *rq, struct proc *p);
+static struct proc *stride_pick_next(struct proc_rq *rq);
+static void stride_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns);
+static void stride_init_rq(struct proc_rq *rq);
+static u64 lottery_subtree_tickets(struct proc *p);
+static void lottery_propagate(struct rb_node *rb, struct rb_node *stop);
+static void lottery_copy(struct rb_node *rb_old, struct rb_node *rb_new);
+static void lottery_rotate(struct rb_node *rb_old, struct rb_node *rb_new);
+static void lottery_enqueue(struct proc_rq *rq, struct proc *p);
+static void lottery_dequeue(struct proc_rq *rq, struct proc *p);
+static struct proc *lottery_pick_next(struct proc_rq *rq);
+static void lottery_init_rq(struct proc_rq *rq);
+
+/**
+	Function Name : share_tickets
+	Function Type : Policy Helper
+	Description   : Method returns the tickets of the process.
+*/
+static unsigned int share_tickets(struct proc *p)
+{
+	return p->attr.tickets != 0 ? p->attr.tickets : default_tickets;
+}
+
+/**
+	Function Name : stride_update_global_pass
+	Function Type : Policy Helper
+	Description   : Method moves the floor of the passes up to the lowest
+					waiting pass. The floor never goes back.
+*/
+static void stride_update_global_pass(struct stride_rq *srq)
+{
+	struct rb_node *leftmost = rb_first_cached(&srq->tasks);
+	struct proc *p;
+
+	if(leftmost != NULL) {
+		p = rb_entry(leftmost, struct proc, se.run_node);
+		if((s64)(p->se.pass - srq->global_pass) > 0) {
+			srq->global_pass = p->se.pass;
+		}
+	}
+}
+
+/**
+	Function Name : stride_enqueue
+	Function Type : Policy Hook
+	Description   : Enqueue hook. Off the tree the pass is kept relative to
+					the floor, so a new process starts at the floor instead
+					of claiming the CPU time it was not there for. O(log n).
+*/
+static void stride_enqueue(struct proc_rq *rq, struct proc *p)
+{
+	struct stride_rq *srq = rq->policy_priv;
+	struct rb_node **link = &srq->tasks.rb_root.rb_node, *parent = NULL;
+	bool leftmost = true;
+
+	p->se.pass += srq->global_pass;
+	/**Walking down to the insertion point, equal passes go right.*/
+	while(*link != NULL) {
+		parent = *link;
+		if((s64)(p->se.pass - rb_entry(parent, struct proc, se.run_node)->se.pass) < 0) {
+			link = &parent->rb_left;
+		}
+		else {
+			link = &parent->rb_right;
+			leftmost = false;
+		}
+	}
+	rb_link_node(&p->se.run_node, parent, link);
+	rb_insert_color_cached(&p->se.run_node, &srq->tasks, leftmost);
+	stride_update_global_pass(srq);
+}
+
+/**
+	Function Name : stride_dequeue
+	Function Type : Policy Hook
+	Description   : Dequeue hook, the pass becomes relative again. O(log n).
+*/
+static void stride_dequeue(struct proc_rq *rq, struct proc *p)
+{
+	struct stride_rq *srq = rq->policy_priv;
+
+	rb_erase_cached(&p->se.run_node, &srq->tasks);
+	RB_CLEAR_NODE(&p->se.run_node);
+	stride_update_global_pass(srq);
+	p->se.pass -= srq->global_pass;
+}
+
+/**
+	Function Name : stride_pick_next
+	Function Type : Policy Hook
+	Description   : Pick next hook, the lowest pass. O(1), the leftmost node
+					is cached.
+*/
+static struct proc *stride_pick_next(struct proc_rq *rq)
+{
+	struct stride_rq *srq = rq->policy_priv;
+
+	return rb_entry_safe(rb_first_cached(&srq->tasks), struct proc, se.run_node);
+}
+
+/**
+	Function Name : stride_tick
+	Function Type : Policy Hook
+	Description   : Tick hook, advances the pass by the stride, the CPU time
+					used scaled by default_tickets over the tickets of the
+					process. Charging the CPU time rather than one stride
+					per dispatch keeps the shares exact when slices vary.
+*/
+static void stride_tick(struct proc_rq *rq, struct proc *p, u64 ran_ns)
+{
+	p->se.pass += div_u64(ran_ns * default_tickets, share_tickets(p));
+}
+
+/**
+	Function Name : stride_init_rq
+	Function Type : Policy Hook
+	Description   : Init hook, an empty tree.
+*/
+static void stride_init_rq(struct proc_rq *rq)
+{
+	struct stride_rq *srq = rq->policy_priv;
+
+	srq->tasks = RB_ROOT_CACHED;
+	srq->global_pass = 0;
+}
+
+/**
+	Function Name : lottery_subtree_tickets
+	Function Type : Policy Helper
+	Description   : Method computes the tickets of the subtree rooted at the
+					process from the sums cached in its children.
+*/
+static u64 lottery_subtree_tickets(struct proc *p)
+{
+	u64 sum = share_tickets(p);
+
+	if(p->se.run_node.rb_left != NULL) {
+		sum += rb_entry(p->se.run_node.rb_left, struct proc, se.run_node)->se.subtree_tickets;
+	}
+	if(p->se.run_node.rb_right != NULL) {
+		sum += rb_entry(p->se.run_node.rb_right, struct proc, se.run_node)->se.subtree_tickets;
+	}
+	return sum;
+}
+
+/**
+	Function Name : lottery_propagate
+	Function Type : Augmented Tree Callback
+	Description   : Method refreshes the ticket sums from a node up to stop.
+*/
+static void lottery_propagate(struct rb_node *rb, struct rb_node *stop)
+{
+	struct proc *p;
+	u64 sum;
+
+	while(rb != stop) {
+		p = rb_entry(rb, struct proc, se.run_node);
+		sum = lottery_subtree_tickets(p);
+		if(p->se.subtree_tickets == sum) {
+			break;
+		}
+		p->se.subtree_tickets = sum;
+		rb = rb_parent(&p->se.run_node);
+	}
+}
+
+/**
+	Function Name : lottery_copy
+	Function Type : Augmented Tree Callback
+	Description   : Method hands the ticket sum over to the replacing node.
+*/
+static void lottery_copy(struct rb_node *rb_old, struct rb_node *rb_new)
+{
+	rb_entry(rb_new, struct proc, se.run_node)->se.subtree_tickets =
+		rb_entry(rb_old, struct proc, se.run_node)->se.subtree_tickets;
+}
+
+/**
+	Function Name : lottery_rotate
+	Function Type : Augmented Tree Callback
+	Description   : Method fixes the ticket sums of a rotation, the new top
+					takes the old sum, the old top is recomputed.
+*/
+static void lottery_rotate(struct rb_node *rb_old, struct rb_node *rb_new)
+{
+	struct proc *old = rb_entry(rb_old, struct proc, se.run_node);
+
+	rb_entry(rb_new, struct proc, se.run_node)->se.subtree_tickets = old->se.subtree_tickets;
+	old->se.subtree_tickets = lottery_subtree_tickets(old);
+}
+
+/** Augmented tree callbacks keeping the ticket sums. */
+static const struct rb_augment_callbacks lottery_callbacks = {
+	.propagate	= lottery_propagate,
+	.copy		= lottery_copy,
+	.rotate		= lottery_rotate,
+};
+
+/**
+	Function Name : lottery_enqueue
+	Function Type : Policy Hook
+	Description   : Enqueue hook, links the process by pid and adds its
+					tickets to every subtree on the way down. O(log n).
+*/
+static void lottery_enqueue(struct proc_rq *rq, struct proc *p)
+{
+	struct lottery_rq *lrq = rq->policy_priv;
+	struct rb_node **link = &lrq->tasks.rb_node, *parent = NULL;
+	struct proc *q;
+	unsigned int tickets = share_tickets(p);
+
+	while(*link != NULL) {
+		parent = *link;
+		q = rb_entry(parent, struct proc, se.run_node);
+		q->se.subtree_tickets += tickets;
+		link = p->pid < q->pid ? &parent->rb_left : &parent->rb_right;
+	}
+	p->se.subtree_tickets = tickets;
+	rb_link_node(&p->se.run_node, parent, link);
+	rb_insert_augmented(&p->se.run_node, &lrq->tasks, &lottery_callbacks);
+}
+
+/**
+	Function Name : lottery_dequeue
+	Function Type : Policy Hook
+	Description   : Dequeue hook. O(log n).
+*/
+static void lottery_dequeue(struct proc_rq *rq, struct proc *p)
+{
+	struct lottery_rq *lrq = rq->policy_priv;
+
+	rb_erase_augmented(&p->se.run_node, &lrq->tasks, &lottery_callbacks);
+	RB_CLEAR_NODE(&p->se.run_node);
+}
+
+/**
+	Function Name : lottery_pick_next
+	Function Type : Policy Hook
+	Description   : Pick next hook, draws one ticket among all the waiting
+					ones and walks down to its holder using the subtree
+					sums. O(log n).
+*/
+static struct proc *lottery_pick_next(struct proc_rq *rq)
+{
+	struct lottery_rq *lrq = rq->policy_priv;
+	struct rb_node *rb = lrq->tasks.rb_node;
+	struct proc *p, *left;
+	u64 winner, tickets;
+
+	if(rb == NULL) {
+		return NULL;
+	}
+	div64_u64_rem(get_random_u64(), rb_entry(rb, struct proc, se.run_node)->se.subtree_tickets, &winner);
+	while(rb != NULL) {
+		p = rb_entry(rb, struct proc, se.run_node);
+		if(rb->rb_left != NULL) {
+			left = rb_entry(rb->rb_left, struct proc, se.run_node);
+			if(winner < left->se.subtree_tickets) {
+				rb = rb->rb_left;
+				continue;
+			}
+			winner -= left->se.subtree_tickets;
+		}
+		tickets = share_tickets(p);
+		if(winner < tickets) {
+			return p;
+		}
+		winner -= tickets;
+		rb = rb->rb_right;
+	}
+	/**Not reached while the sums are consistent.*/
+	return NULL;
+}
+
+/**
+	Function Name : lottery_init_rq
+	Function Type : Policy Hook
+	Description   : Init hook, an empty tree.
+*/
+static void lottery_init_rq(struct proc_rq *rq)
+{
+	struct lottery_rq *lrq = rq->policy_priv;
+
+	lrq->tasks = RB_ROOT;
+}
+
+/**Stride policy.*/
+static struct sched_policy_ops stride_policy = {
+	.name			= "stride",
+	.owner			= THIS_MODULE,
+	.rq_priv_size	= sizeof(struct stride_rq),
+	.enqueue		= stride_enqueue,
+	.dequeue		= stride_dequeue,
+	.pick_next		= stride_pick_next,
+	.tick			= stride_tick,
+	.init_rq		= stride_init_rq,
+};
+
+/**Lottery policy.*/
+static struct sched_policy_ops lottery_policy = {
+	.name			= "lottery",
+	.owner			= THIS_MODULE,
+	.rq_priv_size	= sizeof(struct lottery_rq),
+	.enqueue		= lottery_enqueue,
+	.dequeue		= lottery_dequeue,
+	.pick_next		= lottery_pick_next,
+	.init_rq		= lottery_init_rq,
+};
+
+/**
+	Function Name : policy_stride_module_init
+	Function Type : Module INIT
+	Description   : Initialization method of the Kernel module. The
+			method gets invoked when the kernel module is being
+			inserted using the command insmod.
+*/
+static int __init policy_stride_module_init(void)
+{
+	int ret;
+
+	printk(KERN_INFO "Stride Policy module is being loaded.\n");
+
+	if(default_tickets == 0) {
+		printk(KERN_ERR "Stride Policy ERROR:default_tickets must be positive\n");
+		return -EINVAL;
+	}
+	/**Making the policies selectable, they are installed once selected.*/
+	ret = register_sched_policy(&stride_policy);
+	if(ret != 0) {
+		return ret;
+	}
+	ret = register_sched_policy(&lottery_policy);
+	if(ret != 0) {
+		unregister_sched_policy(&stride_policy);
+	}
+	return ret;
+}
+
+/**
+	Function Name : policy_stride_module_cleanup
+	Function Type : Module EXIT
+	Description   : Cleanup method of the Kernel module. The
+                	method gets invoked when the kernel module is being
+                 	removed using the command rmmod.
+*/
+static void __exit policy_stride_module_cleanup(void)
+{
+	printk(KERN_INFO "Stride Policy module is being unloaded.\n");
+	unregister_sched_policy(&lottery_policy);
+	unregister_sched_policy(&stride_policy);
+}
+
+/** Initializing the kernel module init with custom init method */
+module_init(policy_stride_module_init);
+/** Initializing the kernel module exit with custom cleanup method */
+module_exit(policy_stride_module_cleanup);
+
+/**Initializing the default ticket count*/
+module_param(default_tickets, uint, 0);
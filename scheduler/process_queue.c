@@ -12,26 +12,41 @@
 #include <linux/proc_fs.h>
 #include <linux/kernel.h>
 #include <linux/list.h>
+#include <linux/hashtable.h>
 #include <linux/slab.h>
+#include <linux/atomic.h>
+#include <linux/moduleparam.h>
 #include <linux/sched.h>
+#include <linux/pid.h>
+#include <linux/rcupdate.h>
+#include <linux/rculist.h>
+#include <linux/spinlock.h>
+#include <linux/percpu.h>
+#include <linux/cpumask.h>
+#include <linux/mutex.h>
+#include <linux/rbtree.h>
+#include <linux/string.h>
+#include <linux/tracepoint.h>
+#include <linux/irq_work.h>
+#include <linux/smp.h>
+#include <linux/llist.h>
+#include <linux/workqueue.h>
+#include <linux/seq_file.h>
+#include <linux/cgroup.h>
+#include <linux/err.h>
+#include "sched_policy.h"
+/**Creating the trace events here, the other modules use the exported ones.*/
+#define CREATE_TRACE_POINTS
+#include "process_sched_trace.h"
 MODULE_AUTHOR("Sreeram Sadasivam");
 MODULE_DESCRIPTION("Process Queue Module");
 MODULE_LICENSE("GPL");
 
 /**Macros*/
-#define ALL_REG_PIDS	-100
-#define	INVALID_PID		-1
-
-/**Enumeration for Process States*/
-enum process_state {
-	
-	eCreated		=	0, /**Process in Created State*/
-	eRunning		=	1, /**Process in Running State*/
-	eWaiting		=	2, /**Process in Waiting State*/
-	eBlocked		=	3, /**Process in Blocked State*/
-	eTerminated		=	4  /**Process in Terminate State*/
-};
-
+/**Number of bits used for the pid hash index (1024 buckets).*/
+#define PROC_HASH_BITS	10
+/**Number of bits used for the gang hash index (256 buckets).*/
+#define GANG_HASH_BITS	8
 
 /**Enumeration for Task Errors*/
 enum task_status_code {
@@ -40,385 +55,3260 @@ enum task_status_code {
 	eTaskStatusTerminated 	=  -1   /**Task has terminated.1*/
 };
 
-/** Structure for a process */
-struct proc {
+/**Enumeration for the scheduler tracepoints the queue hooks*/
+enum queue_probe_id {
+
+	eProbeExit		=	0, /**sched_process_exit, removes the exiting processes.*/
+	eProbeSwitch	=	1, /**sched_switch, notices the running process going to sleep.*/
+	eProbeWakeup	=	2, /**sched_wakeup, brings the blocked processes back.*/
+	eProbeFork		=	3, /**sched_process_fork, registers the children of the processes.*/
+	eProbeCount		=	4  /**Number of hooked tracepoints.*/
+};
+
+/**Structure for a hooked scheduler tracepoint*/
+struct queue_probe {
+
+	const char *name;			/**Name of the tracepoint.*/
+	void *probe;				/**Probe function, prototype of the tracepoint.*/
+	struct tracepoint *tp;		/**Tracepoint found in the kernel, NULL if not hooked.*/
+};
+
+/**Number of buckets of the latency histograms, the last one also counts every longer latency.*/
+#define LAT_HIST_BUCKETS	32
+
+/**
+	Structure for a latency histogram with log2 buckets, bucket i counting
+	the latencies in [2^i, 2^(i+1)) ns. Updated by the probes of its CPU
+	only, read locklessly.
+*/
+struct lat_hist {
+
+	unsigned long buckets[LAT_HIST_BUCKETS];	/**Number of latencies of every bucket.*/
+	unsigned long count;						/**Number of latencies measured.*/
+	u64 max_ns;									/**Longest latency measured.*/
+};
+
+/**
+	Structure for an enforcement backend, the way the tasks of the
+	registered processes are stopped and continued. Unless it works per
+	thread, a backend stops and continues whole thread groups, so the
+	queue only asks for it when a gang starts or stops. run and stop return 0
+	or a negative errno. Unless the backend sleeps they are called with
+	the run queue spinlock of cpu held, otherwise from the enforcement
+	work of cpu, in the order the queue asked for them. attach and detach
+	are optional and called from process context when a process is
+	registered and removed.
+*/
+struct task_enforce_ops {
+
+	const char *name;							/**Name selecting the backend.*/
+	bool sleeps;								/**run and stop may sleep.*/
+	bool parks;									/**Waiting tasks are moved off their CPU, the queue leaves their affinity alone.*/
+	bool per_thread;							/**run and stop act on the thread, not on its whole thread group.*/
+	int (*run)(struct pid *pid_ref, int cpu);	/**The task runs on cpu.*/
+	int (*stop)(struct pid *pid_ref, int cpu);	/**The task stops using cpu.*/
+	int (*attach)(struct pid *pid_ref);			/**The task is about to be registered, an error turns it down.*/
+	void (*detach)(struct pid *pid_ref);		/**The task is no longer scheduled by the queue.*/
+};
+
+/**
+	Structure for the gang of a thread group. Every registered thread is a
+	member of the gang of its thread group, a process of a single thread
+	is a gang of one. The members are spread over the CPUs and dispatched
+	as a unit, each keeping its own node and statistics.
+*/
+struct proc_gang {
+
+	struct hlist_node hnode;	/**Link in the gang hash index, keyed by tgid.*/
+	pid_t tgid;					/**Thread group of the gang.*/
+	unsigned int nr_members;	/**Number of registered threads, under the gang hash spinlock.*/
+	spinlock_t lock;			/**Spinlock serializing the fields below, nested inside the run queue locks.*/
+	struct list_head members;	/**Registered threads of the group.*/
+	unsigned int nr_on;			/**Number of members dispatched on their CPU.*/
+	int leader_pid;				/**Member whose dispatch got the gang running, INVALID_PID if none.*/
+	int home_cpu;				/**CPU whose work orders the thread group changes of a sleeping backend.*/
+	struct enforce_pending enforce;	/**Thread group change pending for a backend that sleeps.*/
+	struct rcu_head rcu;		/**RCU head deferring the release past the readers of its members.*/
+};
+
+/**
+	Structure for a child of a registered process, queued by the fork
+	probe until a work item registers it with the attributes of its parent.
+*/
+struct forked_proc {
+
+	struct llist_node node;			/**Link in the list of children to register.*/
+	struct pid *pid_ref;			/**Counted reference to the pid of the child.*/
+	struct proc_sched_attr attr;	/**Scheduling attributes inherited from the parent.*/
+	bool stopped;					/**Stopped by the probe, continued if it cannot be registered.*/
+};
+
+/**
+	Structure for a per CPU run queue. It holds the sub-queues of the
+	groups that have waiting processes on the CPU, ordered by their
+	vruntime, and picks the group before the policy of the group picks
+	the process.
+*/
+struct proc_cpu_rq {
+
+	spinlock_t lock;			/**Spinlock serializing the writers of this run queue and of the sub-queues of its CPU.*/
+	unsigned int nr_procs;		/**Number of processes assigned to this CPU, the running one included.*/
+	struct proc *curr;			/**Process currently dispatched on this CPU or NULL.*/
+	u64 burst_sum_ns;			/**Sum of last_burst_ns over the processes assigned to this CPU.*/
+	int cpu;					/**CPU owning the run queue.*/
+	struct rb_root_cached groups;	/**Sub-queues with waiting processes, ordered by vruntime.*/
+	u64 min_vruntime;			/**Monotonic floor of the vruntime of the groups picked on this CPU.*/
+	struct list_head blocked;	/**Processes that went to sleep while running, in eBlocked state.*/
+	struct irq_work wake_work;	/**Interrupt work bringing the woken blocked processes back.*/
+	bool tick_stopped;			/**Nothing waited at the last switch, the tick of the CPU is stopped.*/
+	unsigned long nr_ticks;		/**Number of switch requests served.*/
+	unsigned long nr_switches;	/**Number of switches that changed the running process.*/
+	u64 tick_sum_ns;			/**Time spent serving the switch requests.*/
+	u64 tick_max_ns;			/**Longest switch request.*/
+	int cont_pid;				/**Process continued by the last switch, until it is on the CPU, or INVALID_PID.*/
+	u64 cont_ns;				/**Time it was continued.*/
+	int stop_pid;				/**Process stopped by the last switch, until it is off the CPU, or INVALID_PID.*/
+	u64 stop_ns;				/**Time it was stopped.*/
+	struct lat_hist dispatch_lat;	/**Latencies from the continue request to on the CPU.*/
+	struct lat_hist stop_lat;		/**Latencies from SIGSTOP to off the CPU.*/
+	int gang_pull_pid;			/**Member of a gang running elsewhere to dispatch at the next switch, or INVALID_PID.*/
+	spinlock_t enforce_lock;	/**Spinlock serializing the pending changes, innermost of all.*/
+	struct list_head enforce_list;	/**Changes pending for a sleeping backend, oldest first.*/
+	struct enforce_pending *enforce_busy;	/**Change being applied by the work, NULL if none.*/
+	struct work_struct enforce_work;	/**Work applying the pending changes on this CPU.*/
+	unsigned long nr_enforced;	/**Number of task state changes applied.*/
+	unsigned long nr_enforce_coalesced;	/**Number of changes replaced by a later one before being applied.*/
+	u64 enforce_sum_ns;			/**Time spent applying the changes.*/
+	u64 enforce_max_ns;			/**Longest change.*/
+};
+
+/**
+	One run queue per CPU. Every registered process belongs to exactly one
+	of them and is pinned to its CPU, each CPU runs one process at a time.
+*/
+static DEFINE_PER_CPU(struct proc_cpu_rq, proc_rqs);
+
+/**
+	List of the groups, the default one first. Changed under the policy
+	mutex and walked under RCU from the run queues.
+*/
+static LIST_HEAD(proc_groups);
+
+/**Group of the processes registered without one, never removed.*/
+static struct proc_group *default_group;
+
+/**Sum of the weights of the groups, changed under the policy mutex.*/
+static unsigned int total_group_weight;
+
+/**
+	Hash index over the run queues keyed by pid. The dispatch order is
+	kept by the policies of the run queues, the index only makes finding
+	a given pid O(1).
+*/
+static DEFINE_HASHTABLE(proc_hash, PROC_HASH_BITS);
+
+/**
+	Spinlock serializing the writers of the hash index. Always nested
+	inside the run queue lock of the node being inserted or removed.
+*/
+static DEFINE_SPINLOCK(hash_lock);
+
+/**Hash index of the gangs keyed by tgid, used when a thread registers.*/
+static DEFINE_HASHTABLE(gang_hash, GANG_HASH_BITS);
+
+/**Spinlock serializing the gang hash index and the member counts, nested inside the run queue locks.*/
+static DEFINE_SPINLOCK(gang_lock);
+
+/**Slab cache backing every struct proc node of the queue.*/
+static struct kmem_cache *proc_cache;
+
+/**
+	Number of struct proc allocations done since the module was loaded.
+	A scheduler with a stable set of PIDs should not move this counter
+	between ticks.
+*/
+static atomic_long_t proc_alloc_count = ATOMIC_LONG_INIT(0);
+
+/**Mutex serializing the policy installations, the changes to the group list and the registrations.*/
+static DEFINE_MUTEX(policy_mutex);
+
+/**
+	Children of registered processes join the scheduler by themselves when
+	set, through /sys/module/process_queue/parameters/follow_fork.
+*/
+static bool follow_fork = false;
+
+/**Name of the enforcement backend stopping and continuing the tasks, chosen at load time.*/
+static char *enforce = "signal";
+
+/**Mount point of the cgroup v2 hierarchy, freezer backend.*/
+static char *cgroup_mount = "/sys/fs/cgroup";
+
+/**CPU the waiting tasks are parked on, park backend. -1 for the last online CPU.*/
+static int park_cpu = -1;
+
+/**Enforcement backend in use, set once at load time.*/
+static const struct task_enforce_ops *task_enforce;
+
+/**
+	Callback of the process scheduler asking a CPU to switch before its
+	slice ends, or to restart its stopped tick when now is false. NULL
+	while no scheduler is loaded. Read under RCU.
+*/
+static void (*resched_cpu_fn)(int cpu, bool now);
 
-	int pid; 					/**Process ID*/
-	enum process_state state;	/**Process State*/
-	struct list_head list;		/**List pointer for generating a list of processes.*/
-	/**More things to come in future such as nice value, priority etc,.*/
-}top;
+/**
+	Walks a group sub-queue under RCU. A node stolen by another CPU while a
+	reader stands on it leads the reader into the other run queue, so the
+	walk stops at the first list head it meets, whichever run queue it
+	belongs to. List heads are the only nodes carrying INVALID_PID.
+*/
+#define for_each_process_in_rq_rcu(node, rq) \
+	for(node = list_entry_rcu((rq)->top.list.next, struct proc, list); \
+		node->pid != INVALID_PID; \
+		node = list_entry_rcu(node->list.next, struct proc, list))
 
-/**Semaphore for process queue*/
-static struct semaphore mutex;
+/**
+	Walks the groups, under RCU or with the policy mutex held. A group is
+	only removed once it has no process left.
+*/
+#define for_each_process_group(group) \
+	list_for_each_entry_rcu(group, &proc_groups, list)
 
 /**Function Prototypes for Task Queue Functions*/
-enum task_status_code task_status_change(int pid, enum process_state eState);
-enum task_status_code is_task_exists(int pid);
+enum task_status_code task_status_change(struct pid *pid_ref, int cpu, struct enforce_pending *pend, enum process_state eState);
+enum task_status_code is_task_exists(struct pid *pid_ref);
+enum task_status_code task_affinity_change(struct pid *pid_ref, const struct cpumask *mask);
+u64 task_cputime_ns(struct pid *pid_ref);
+bool is_task_blocked(struct pid *pid_ref);
+static struct pid *find_get_global_pid(int pid);
+static int signal_enforce_run(struct pid *pid_ref, int cpu);
+static int signal_enforce_stop(struct pid *pid_ref, int cpu);
+static struct file *freezer_enforce_open(struct pid *pid_ref, const char *name, int flags, pid_t *tgid);
+static int freezer_enforce_write(struct pid *pid_ref, const char *value);
+static int freezer_enforce_run(struct pid *pid_ref, int cpu);
+static int freezer_enforce_stop(struct pid *pid_ref, int cpu);
+static int freezer_enforce_attach(struct pid *pid_ref);
+static void freezer_enforce_detach(struct pid *pid_ref);
+static int park_enforce_run(struct pid *pid_ref, int cpu);
+static int park_enforce_stop(struct pid *pid_ref, int cpu);
+static void apply_task_enforce(struct proc_cpu_rq *crq, struct pid *pid_ref, int cpu, enum process_state state);
+static void init_task_enforce(struct enforce_pending *pend);
+static void queue_task_enforce(struct proc_cpu_rq *crq, struct enforce_pending *pend, struct pid *pid_ref, enum process_state state);
+static void cancel_task_enforce(struct enforce_pending *pend);
+static void enforce_queued_changes(struct work_struct *work);
+static void flush_task_enforce(struct proc_cpu_rq *crq);
+static void release_task_of_process(struct proc_cpu_rq *crq, struct pid *pid_ref, int home_cpu, bool detach);
 
 /**Function Prototypes for Process Queue Functions*/
+static struct proc *find_process_in_queue(int pid);
+static struct proc *lock_process_in_queue(int pid, struct proc_cpu_rq **rqp, unsigned long *flags);
+static struct proc_cpu_rq *pick_rq_for_new_process(struct proc_gang *gang);
+static bool is_sched_cpu(int cpu);
+static struct proc_rq *group_rq_of(struct proc *node);
+static void free_process_node(struct proc *node);
+static void free_process_node_rcu(struct rcu_head *head);
+static void attach_process_node(struct proc_cpu_rq *crq, struct proc *node);
+static void detach_process_node(struct proc_cpu_rq *crq, struct proc *node);
+static void set_curr_process(struct proc_cpu_rq *crq, struct proc *node);
+static void unlink_process_node(struct proc_cpu_rq *crq, struct proc *node);
+static void reap_process_node(struct proc_cpu_rq *crq, struct proc *node);
+static void reap_terminated_processes(struct proc_cpu_rq *crq, struct proc **prev);
+static void account_process_burst(struct proc_cpu_rq *crq, struct proc *node);
+static void account_process_state(struct proc *node, u64 now);
+static void lat_hist_add(struct lat_hist *h, u64 ns);
+static u64 lat_hist_percentile(const struct lat_hist *h, unsigned long count, unsigned int pct);
+static void print_lat_hist(struct seq_file *m, const char *name, const char *cpu, const struct lat_hist *h);
+static void enqueue_group(struct proc_cpu_rq *crq, struct proc_rq *rq);
+static void dequeue_group(struct proc_cpu_rq *crq, struct proc_rq *rq);
+static void charge_group(struct proc_cpu_rq *crq, struct proc_rq *rq, u64 ran_ns);
+static void enqueue_process(struct proc_cpu_rq *crq, struct proc *node);
+static void dequeue_process(struct proc_cpu_rq *crq, struct proc *node);
+static void sync_process_policy(struct proc_cpu_rq *crq, struct proc *node);
+static struct proc *pick_next_process(struct proc_cpu_rq *crq);
+static int admit_process_node(struct proc_cpu_rq *crq, struct proc *node);
+static void cancel_process_admission(struct proc_cpu_rq *crq, struct proc *node);
+static int insert_process_node(struct proc_cpu_rq *crq, struct proc *node);
+static int add_thread_to_queue(int pid, const struct proc_sched_attr *attr);
+static struct proc_gang *get_process_gang(struct pid *pid_ref);
+static void put_process_gang(struct proc_gang *gang);
+static void leave_process_gang(struct proc *node);
+static void kick_gang_members(struct proc_gang *gang, struct proc *node, bool pull);
+static enum task_status_code change_task_of_process(struct proc *node, enum process_state state);
+static struct proc *pull_gang_process(struct proc_cpu_rq *crq);
+static struct proc_group *find_process_group(const char *name);
+static struct proc_group *alloc_process_group(const char *name, unsigned int weight);
+static void free_process_group(struct proc_group *group);
+void fifo_enqueue_process(struct proc_rq *rq, struct proc *p);
+void fifo_dequeue_process(struct proc_rq *rq, struct proc *p);
+struct proc *fifo_pick_next_process(struct proc_rq *rq);
+int set_process_queue_policy(struct sched_policy_ops *ops);
+int add_process_group(const char *name, unsigned int weight);
+int remove_process_group(const char *name);
+unsigned int process_group_total_weight(void);
 int init_process_queue(void);
 int release_process_queue(void);
 int add_process_to_queue(int pid);
+int add_process_to_queue_attr(int pid, const struct proc_sched_attr *attr);
 int remove_process_from_queue(int pid);
+int rotate_process_queue(int pid);
 int print_process_queue(void);
+int print_process_queue_stats(struct seq_file *m);
 int change_process_state_in_queue(int pid, int changeState);
 int get_first_process_in_queue(void);
 int remove_terminated_processes_from_queue(void);
+int switch_process_in_queue(int cpu, u64 *slice_ns);
+int steal_process_to_cpu(int cpu);
+int get_run_queue_load(int cpu, unsigned int *nr_procs, u64 *avg_burst_ns);
+int yield_process_in_queue(int pid);
+void set_process_queue_resched(void (*resched)(int cpu, bool now));
+static void resched_process_queue_cpu(int cpu, bool now);
+static void kick_idle_process_queue(int busy_cpu);
+static void check_preempt_process(struct proc_cpu_rq *crq, struct proc *node);
+static bool block_process(struct proc_cpu_rq *crq, struct proc *node);
+static void wake_blocked_processes(struct irq_work *work);
+static void probe_process_exit(void *data, struct task_struct *p);
+static void probe_process_switch(void *data, bool preempt, struct task_struct *prev, struct task_struct *next);
+static void probe_process_wakeup(void *data, struct task_struct *p);
+static void probe_process_fork(void *data, struct task_struct *parent, struct task_struct *child);
+static void register_forked_processes(struct work_struct *work);
+static void drain_forked_processes(bool do_register);
+static void find_queue_tracepoints(struct tracepoint *tp, void *priv);
+
+/**
+	Scheduler tracepoints hooked by the queue. While the exit probe is
+	registered, exiting processes are removed at once and the run queues
+	stop polling for dead tasks. While the wakeup probe is registered, a
+	running process that goes to sleep gives its CPU up until it wakes.
+*/
+static struct queue_probe queue_probes[eProbeCount] = {
+	[eProbeExit]	= { .name = "sched_process_exit",	.probe = probe_process_exit },
+	[eProbeSwitch]	= { .name = "sched_switch",			.probe = probe_process_switch },
+	[eProbeWakeup]	= { .name = "sched_wakeup",			.probe = probe_process_wakeup },
+	[eProbeFork]	= { .name = "sched_process_fork",	.probe = probe_process_fork },
+};
+
+/**Enforcement backends, the first one is the default.*/
+static const struct task_enforce_ops task_enforce_backends[] = {
+	{ .name = "signal",		.run = signal_enforce_run,	.stop = signal_enforce_stop },
+	{ .name = "freezer",	.sleeps = true,	.run = freezer_enforce_run,	.stop = freezer_enforce_stop,
+		.attach = freezer_enforce_attach,	.detach = freezer_enforce_detach },
+	{ .name = "park",		.sleeps = true,	.parks = true,	.per_thread = true,	.run = park_enforce_run,	.stop = park_enforce_stop },
+};
+
+/**Children queued by the fork probe, registered by fork_work.*/
+static LLIST_HEAD(forked_procs);
+static DECLARE_WORK(fork_work, register_forked_processes);
 
 /** Process Queue Functions */
 
 /**
-	Function Name : init_process_queue
-	Function Type : Queue Function
-	Description	  :	Method is invoked for initializing a process queue.
+	Function Name : find_process_in_queue
+	Function Type : Queue Lookup
+	Description	  :	Method returns the queue node of the given pid by
+					looking it up in the pid hash index. Caller must
+					be inside an RCU read side critical section or hold
+					the hash spinlock.
 */
-int init_process_queue(void) {
+static struct proc *find_process_in_queue(int pid) {
 
-	printk(KERN_INFO "Initializing the Process Queue...\n");
-	/**Generating the head of the queue and initializing an empty process queue.*/
-	INIT_LIST_HEAD(&top.list);
-	return 0;
+	struct proc *node;
+	/**Walk the hash bucket of the given pid only.*/
+	hash_for_each_possible_rcu(proc_hash, node, hnode, pid) {
+		/**Check if the node pid is the same as the required pid.*/
+		if(node->pid == pid) {
+			return node;
+		}
+	}
+	/**The pid is not registered in the queue.*/
+	return NULL;
 }
 
 /**
-	Function Name : release_process_queue
-	Function Type : Queue Function
-	Description	  :	Method is invoked for releasing a process queue.
+	Function Name : lock_process_in_queue
+	Function Type : Queue Lookup
+	Description	  :	Method looks up the given pid and returns its node with
+					the owning run queue locked. The run queue is rechecked
+					after locking since a steal may move the node meanwhile.
+					Returns NULL, with nothing locked, if the pid is not
+					registered.
 */
-int release_process_queue(void) {
-		 	
+static struct proc *lock_process_in_queue(int pid, struct proc_cpu_rq **rqp, unsigned long *flags) {
+
+	struct proc *node;
+	struct proc_cpu_rq *rq;
+
+	rcu_read_lock();
+	node = find_process_in_queue(pid);
+	while(node != NULL) {
+		rq = per_cpu_ptr(&proc_rqs, READ_ONCE(node->cpu));
+		spin_lock_irqsave(&rq->lock, *flags);
+		/**Check the node is still linked and still owned by the locked run queue.*/
+		if(!hlist_unhashed(&node->hnode) && node->cpu == rq->cpu) {
+			*rqp = rq;
+			break;
+		}
+		spin_unlock_irqrestore(&rq->lock, *flags);
+		if(hlist_unhashed(&node->hnode)) {
+			/**The node was unlinked concurrently.*/
+			node = NULL;
+		}
+	}
+	rcu_read_unlock();
+	return node;
+}
+
+/**
+	Function Name : pick_rq_for_new_process
+	Function Type : Queue Helper
+	Description	  :	Method returns the run queue of the online CPU with the
+					fewest processes, among the CPUs holding no member of
+					the given gang if there is one, so that the threads of
+					a gang get distinct CPUs. The CPU of the parked tasks is
+					left out. Placement only, the counts are read without
+					locking.
+*/
+static struct proc_cpu_rq *pick_rq_for_new_process(struct proc_gang *gang) {
+
+	struct proc_cpu_rq *rq, *best = NULL, *best_free = NULL;
+	struct proc *m;
+	unsigned long flags;
+	bool used;
+	int cpu;
+
+	spin_lock_irqsave(&gang->lock, flags);
+	for_each_online_cpu(cpu) {
+		if(!is_sched_cpu(cpu)) {
+			continue;
+		}
+		rq = per_cpu_ptr(&proc_rqs, cpu);
+		if(best == NULL || READ_ONCE(rq->nr_procs) < READ_ONCE(best->nr_procs)) {
+			best = rq;
+		}
+		/**Gangs have a few members, looking them up per CPU is cheap.*/
+		used = false;
+		list_for_each_entry(m, &gang->members, gang_list) {
+			if(READ_ONCE(m->cpu) == cpu) {
+				used = true;
+				break;
+			}
+		}
+		if(!used && (best_free == NULL || READ_ONCE(rq->nr_procs) < READ_ONCE(best_free->nr_procs))) {
+			best_free = rq;
+		}
+	}
+	spin_unlock_irqrestore(&gang->lock, flags);
+	/**Every other CPU went offline, the parked tasks share the last one.*/
+	if(best == NULL) {
+		best = per_cpu_ptr(&proc_rqs, park_cpu);
+	}
+	return best_free != NULL ? best_free : best;
+}
+
+/**
+	Function Name : is_sched_cpu
+	Function Type : Queue Helper
+	Description	  :	Method tells if processes may be placed on the given
+					CPU. With the park backend, park_cpu only runs the
+					parked tasks, which are runnable there, so no process
+					is registered on it or stolen by it.
+*/
+static bool is_sched_cpu(int cpu) {
+
+	return !task_enforce->parks || cpu != park_cpu;
+}
+
+/**
+	Function Name : group_rq_of
+	Function Type : Queue Helper
+	Description	  :	Method returns the sub-queue of the group of the given
+					process on the CPU of the process. O(1), the group is
+					referenced by the node. Caller must hold the run queue
+					spinlock.
+*/
+static struct proc_rq *group_rq_of(struct proc *node) {
+
+	return per_cpu_ptr(node->group->rqs, node->cpu);
+}
+
+/**
+	Function Name : free_process_node
+	Function Type : Queue Helper
+	Description	  :	Method drops the pid reference held by an unlinked node
+					and returns the node to the slab cache.
+*/
+static void free_process_node(struct proc *node) {
+
+	/**Releasing the reference taken at registration.*/
+	put_pid(node->pid_ref);
+	/**Removing the whole node.*/
+	kmem_cache_free(proc_cache, node);
+}
+
+/**
+	Function Name : free_process_node_rcu
+	Function Type : RCU Callback
+	Description	  :	Method releases a node once every reader that could
+					still see it has left its read side critical section.
+*/
+static void free_process_node_rcu(struct rcu_head *head) {
+
+	free_process_node(container_of(head, struct proc, rcu));
+}
+
+/**
+	Function Name : attach_process_node
+	Function Type : Queue Helper
+	Description	  :	Method links a node at the tail of the sub-queue of its
+					group on its CPU and counts it on both levels. Caller
+					must hold the run queue spinlock.
+*/
+static void attach_process_node(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq = group_rq_of(node);
+
+	list_add_tail_rcu(&(node->list), &(rq->top.list));
+	rq->nr_procs++;
+	rq->burst_sum_ns += node->last_burst_ns;
+	crq->nr_procs++;
+	crq->burst_sum_ns += node->last_burst_ns;
+}
+
+/**
+	Function Name : detach_process_node
+	Function Type : Queue Helper
+	Description	  :	Method unlinks a node, already dequeued, from the
+					sub-queue of its group and uncounts it on both levels.
+					Caller must hold the run queue spinlock.
+*/
+static void detach_process_node(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq = group_rq_of(node);
+
+	/**Clearing the running slot if the node held it.*/
+	if(crq->curr == node) {
+		set_curr_process(crq, NULL);
+	}
+	/**Deleting link pointer established by the node to the list.*/
+	list_del_rcu(&node->list);
+	rq->nr_procs--;
+	rq->burst_sum_ns -= node->last_burst_ns;
+	crq->nr_procs--;
+	crq->burst_sum_ns -= node->last_burst_ns;
+}
+
+/**
+	Function Name : set_curr_process
+	Function Type : Queue Helper
+	Description	  :	Method records the process running on the CPU, or none,
+					in the run queue and in the sub-queue of its group.
+					Caller must hold the run queue spinlock.
+*/
+static void set_curr_process(struct proc_cpu_rq *crq, struct proc *node) {
+
+	if(crq->curr != NULL) {
+		group_rq_of(crq->curr)->curr = NULL;
+	}
+	crq->curr = node;
+	if(node != NULL) {
+		group_rq_of(node)->curr = node;
+	}
+}
+
+/**
+	Function Name : unlink_process_node
+	Function Type : Queue Helper
+	Description	  :	Method removes a node from its run queue, its gang and
+					the hash index and frees it after a grace period.
+					Caller must hold the run queue spinlock.
+*/
+static void unlink_process_node(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq = group_rq_of(node);
+
+	/**Taking the process out of the policy.*/
+	dequeue_process(crq, node);
+	if(rq->policy->task_dead != NULL) {
+		rq->policy->task_dead(rq, node);
+	}
+	detach_process_node(crq, node);
+	/**Leaving the blocked processes if it was asleep.*/
+	list_del_init(&node->block_list);
+	/**Leaving the gang of its thread group.*/
+	leave_process_gang(node);
+	/**A change still pending is moot, the task is gone or given back.*/
+	cancel_task_enforce(&node->enforce);
+	/**The group may be removed once it has no process left.*/
+	atomic_dec(&node->group->nr_procs);
+	/**Dropping the node from the pid hash index.*/
+	spin_lock(&hash_lock);
+	hash_del_rcu(&node->hnode);
+	spin_unlock(&hash_lock);
+	/**Releasing the whole node once concurrent readers are done with it.*/
+	call_rcu(&node->rcu, free_process_node_rcu);
+}
+
+/**
+	Function Name : reap_process_node
+	Function Type : Queue Helper
+	Description	  :	Method unlinks the node of a process whose task is gone
+					or terminated, reporting it to the reap trace event.
+					Caller must hold the run queue spinlock.
+*/
+static void reap_process_node(struct proc_cpu_rq *crq, struct proc *node) {
+
+	trace_process_sched_reap(node->pid, crq->cpu);
+	unlink_process_node(crq, node);
+}
+
+/**
+	Function Name : reap_terminated_processes
+	Function Type : Queue Helper
+	Description	  :	Method removes the terminated processes of one run
+					queue, all groups included. If the process pointed to
+					by prev is removed, prev is cleared. Caller must hold
+					the run queue spinlock.
+*/
+static void reap_terminated_processes(struct proc_cpu_rq *crq, struct proc **prev) {
+
 	struct proc *tmp, *node;
-	printk(KERN_INFO "Releasing Process Queue...\n");
+	struct proc_group *group;
+
+	rcu_read_lock();
+	for_each_process_group(group) {
+		/**Iterate over the sub-queue of the group and remove all terminated processes.*/
+		list_for_each_entry_safe(node, tmp, &(per_cpu_ptr(group->rqs, crq->cpu)->top.list), list) {
+
+			/**Check if the process is terminated or its task is gone.*/
+			if(node->state == eTerminated || is_task_exists(node->pid_ref) == eTaskStatusTerminated) {
+				if(prev != NULL && node == *prev) {
+					*prev = NULL;
+				}
+				reap_process_node(crq, node);
+			}
+		}
+	}
+	rcu_read_unlock();
+}
+
+/**
+	Function Name : get_process_gang
+	Function Type : Queue Helper
+	Description	  :	Method returns the gang of the thread group of the given
+					task, created for its first registered thread, counting
+					one more member in it. NULL if the task is gone or the
+					memory is short. Must be called from process context.
+*/
+static struct proc_gang *get_process_gang(struct pid *pid_ref) {
+
+	struct proc_gang *gang, *new_gang;
+	struct task_struct *task;
+	unsigned long flags;
+	pid_t tgid;
+
+	task = get_pid_task(pid_ref, PIDTYPE_PID);
+	if(task == NULL) {
+		return NULL;
+	}
+	tgid = task_tgid_nr(task);
+	put_task_struct(task);
+	/**Allocating ahead, the hash spinlock is taken by the run queues.*/
+	new_gang = kzalloc(sizeof(*new_gang), GFP_KERNEL);
+	if(new_gang == NULL) {
+		return NULL;
+	}
+	spin_lock_irqsave(&gang_lock, flags);
+	hash_for_each_possible(gang_hash, gang, hnode, tgid) {
+		if(gang->tgid == tgid) {
+			break;
+		}
+	}
+	if(gang == NULL) {
+		gang = new_gang;
+		new_gang = NULL;
+		gang->tgid = tgid;
+		spin_lock_init(&gang->lock);
+		INIT_LIST_HEAD(&gang->members);
+		gang->leader_pid = INVALID_PID;
+		gang->home_cpu = -1;
+		init_task_enforce(&gang->enforce);
+		hash_add(gang_hash, &gang->hnode, tgid);
+	}
+	gang->nr_members++;
+	spin_unlock_irqrestore(&gang_lock, flags);
+	kfree(new_gang);
+	return gang;
+}
+
+/**
+	Function Name : put_process_gang
+	Function Type : Queue Helper
+	Description	  :	Method uncounts a member of the given gang, released
+					after a grace period once it has none left.
+*/
+static void put_process_gang(struct proc_gang *gang) {
+
+	unsigned long flags;
+	bool last;
+
+	spin_lock_irqsave(&gang_lock, flags);
+	last = --gang->nr_members == 0;
+	if(last) {
+		hash_del(&gang->hnode);
+		cancel_task_enforce(&gang->enforce);
+	}
+	spin_unlock_irqrestore(&gang_lock, flags);
+	if(last) {
+		kfree_rcu(gang, rcu);
+	}
+}
+
+/**
+	Function Name : leave_process_gang
+	Function Type : Queue Helper
+	Description	  :	Method takes a node out of its gang. If it was the last
+					dispatched member, the thread group is stopped through
+					a remaining member, the task of the node may be gone.
+					Caller must hold the run queue spinlock.
+*/
+static void leave_process_gang(struct proc *node) {
+
+	struct proc_gang *gang = node->gang;
+	struct proc *m;
+
+	spin_lock(&gang->lock);
+	list_del_init(&node->gang_list);
+	if(node->gang_on) {
+		node->gang_on = false;
+		gang->nr_on--;
+		if(gang->leader_pid == node->pid) {
+			gang->leader_pid = INVALID_PID;
+			kick_gang_members(gang, node, false);
+		}
+		if(gang->nr_on == 0 && !task_enforce->per_thread && !list_empty(&gang->members)) {
+			m = list_first_entry(&gang->members, struct proc, gang_list);
+			task_status_change(m->pid_ref, task_enforce->sleeps ? gang->home_cpu : node->cpu, &gang->enforce, eWaiting);
+		}
+	}
+	spin_unlock(&gang->lock);
+	put_process_gang(gang);
+}
+
+/**
+	Function Name : kick_gang_members
+	Function Type : Queue Helper
+	Description	  :	Method asks the CPUs of the other members of a gang for
+					a switch. With pull, a waiting member is dispatched at
+					the next switch of its CPU, at once if the CPU is idle.
+					Otherwise the dispatched members are switched out at
+					once. The members are read without their run queue
+					spinlock, a stale one only costs a useless switch.
+					Gang spinlock must be held.
+*/
+static void kick_gang_members(struct proc_gang *gang, struct proc *node, bool pull) {
+
+	struct proc_cpu_rq *crq;
+	struct proc *m;
+	int cpu;
+
+	list_for_each_entry(m, &gang->members, gang_list) {
+		cpu = READ_ONCE(m->cpu);
+		/**A CPU runs one member at a time.*/
+		if(m == node || cpu == node->cpu) {
+			continue;
+		}
+		crq = per_cpu_ptr(&proc_rqs, cpu);
+		if(pull && READ_ONCE(m->state) == eWaiting) {
+			WRITE_ONCE(crq->gang_pull_pid, m->pid);
+			resched_process_queue_cpu(cpu, READ_ONCE(crq->curr) == NULL);
+		}
+		else if(!pull && m->gang_on) {
+			resched_process_queue_cpu(cpu, true);
+		}
+	}
+}
+
+/**
+	Function Name : change_task_of_process
+	Function Type : Queue Helper
+	Description	  :	Method changes the task of the given process as a member
+					of its gang, which counts its dispatched members. A
+					backend acting on whole thread groups continues the
+					group when its first member is dispatched and stops it
+					when its last one is preempted. A member asleep or gone
+					leaves the others running. With a backend that sleeps
+					these changes are queued on the CPU of the first member,
+					so they stay in order whichever CPU asks. A backend
+					acting on threads changes every member on its own. The
+					member dispatched while nothing of its gang runs leads
+					it: the waiting members are pulled onto their CPUs, and
+					once it is switched out so are the others. Caller must
+					hold the run queue spinlock of the process.
+*/
+static enum task_status_code change_task_of_process(struct proc *node, enum process_state state) {
+
+	struct proc_gang *gang = node->gang;
+	enum task_status_code status;
+	bool on = state == eRunning, apply;
+
+	spin_lock(&gang->lock);
+	if(on != node->gang_on) {
+		node->gang_on = on;
+		if(on) {
+			gang->nr_on++;
+		}
+		else {
+			gang->nr_on--;
+		}
+		if(!on && gang->leader_pid == node->pid) {
+			gang->leader_pid = INVALID_PID;
+			kick_gang_members(gang, node, false);
+		}
+	}
+	if(on && gang->leader_pid == INVALID_PID) {
+		gang->leader_pid = node->pid;
+		kick_gang_members(gang, node, true);
+	}
+	if(task_enforce->per_thread) {
+		status = task_status_change(node->pid_ref, node->cpu, &node->enforce, state);
+	}
+	else {
+		apply = on ? gang->nr_on == 1 : gang->nr_on == 0 && state == eWaiting;
+		status = apply ? task_status_change(node->pid_ref, task_enforce->sleeps ? gang->home_cpu : node->cpu, &gang->enforce, state) :
+			is_task_exists(node->pid_ref);
+	}
+	spin_unlock(&gang->lock);
+	return status;
+}
+
+/**
+	Function Name : pull_gang_process
+	Function Type : Queue Helper
+	Description	  :	Method takes out of its policy the member of a running
+					gang another CPU asked this one to dispatch. NULL if
+					none was asked for, or if it since moved, was dispatched
+					or its gang stopped. Caller must hold the run queue
+					spinlock.
+*/
+static struct proc *pull_gang_process(struct proc_cpu_rq *crq) {
+
+	struct proc *node;
+	int pid = xchg(&crq->gang_pull_pid, INVALID_PID);
+
+	if(pid == INVALID_PID) {
+		return NULL;
+	}
+	rcu_read_lock();
+	node = find_process_in_queue(pid);
+	/**A node of this CPU stays valid past the read side, its spinlock is held.*/
+	if(node != NULL && (node->cpu != crq->cpu || node->state != eWaiting || READ_ONCE(node->gang->nr_on) == 0)) {
+		node = NULL;
+	}
+	rcu_read_unlock();
+	if(node != NULL) {
+		dequeue_process(crq, node);
+	}
+	return node;
+}
+
+/**
+	Function Name : account_process_burst
+	Function Type : Queue Helper
+	Description	  :	Method records the CPU time the running process used
+					since its dispatch, read from the runtime the kernel
+					scheduler accounted to the task, and restarts the
+					measurement. Caller must hold the run
+					queue spinlock.
+*/
+static void account_process_burst(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq = group_rq_of(node);
+	u64 now_ns = task_cputime_ns(node->pid_ref);
+
+	rq->burst_sum_ns -= node->last_burst_ns;
+	crq->burst_sum_ns -= node->last_burst_ns;
+	node->last_burst_ns = now_ns > node->dispatch_cputime_ns ? now_ns - node->dispatch_cputime_ns : 0;
+	rq->burst_sum_ns += node->last_burst_ns;
+	crq->burst_sum_ns += node->last_burst_ns;
+	node->dispatch_cputime_ns = now_ns;
+}
+
+/**
+	Function Name : account_process_state
+	Function Type : Queue Helper
+	Description	  :	Method charges the time since the last state change of
+					the process to its running or waiting time, before its
+					state changes. Time asleep is not charged. Caller must
+					hold the run queue spinlock.
+*/
+static void account_process_state(struct proc *node, u64 now) {
+
+	u64 delta = now > node->stats.stamp_ns ? now - node->stats.stamp_ns : 0;
+
+	if(node->state == eRunning) {
+		node->stats.run_ns += delta;
+	}
+	else if(node->state == eWaiting) {
+		node->stats.wait_ns += delta;
+	}
+	node->stats.stamp_ns = now;
+}
+
+/**
+	Function Name : enqueue_group
+	Function Type : Queue Helper
+	Description	  :	Method inserts a sub-queue in the tree of the groups of
+					its CPU, ordered by vruntime. Equal keys go right, so
+					groups of equal vruntime take turns. O(log g) in the
+					number of groups. Caller must hold the run queue spinlock.
+*/
+static void enqueue_group(struct proc_cpu_rq *crq, struct proc_rq *rq) {
+
+	struct rb_node **link = &crq->groups.rb_root.rb_node, *parent = NULL;
+	bool leftmost = true;
+
+	while(*link != NULL) {
+		parent = *link;
+		if(rq->vruntime < rb_entry(parent, struct proc_rq, group_node)->vruntime) {
+			link = &parent->rb_left;
+		}
+		else {
+			link = &parent->rb_right;
+			leftmost = false;
+		}
+	}
+	rb_link_node(&rq->group_node, parent, link);
+	rb_insert_color_cached(&rq->group_node, &crq->groups, leftmost);
+}
+
+/**
+	Function Name : dequeue_group
+	Function Type : Queue Helper
+	Description	  :	Method removes a sub-queue from the tree of the groups
+					of its CPU. Caller must hold the run queue spinlock.
+*/
+static void dequeue_group(struct proc_cpu_rq *crq, struct proc_rq *rq) {
+
+	rb_erase_cached(&rq->group_node, &crq->groups);
+	RB_CLEAR_NODE(&rq->group_node);
+}
+
+/**
+	Function Name : charge_group
+	Function Type : Queue Helper
+	Description	  :	Method charges a group for the CPU time one of its
+					processes used on the CPU, scaled by the default weight
+					over the weight of the group. A sub-queue in the tree is
+					reinserted at its new key. Caller must hold the run
+					queue spinlock.
+*/
+static void charge_group(struct proc_cpu_rq *crq, struct proc_rq *rq, u64 ran_ns) {
+
+	bool queued = rq->nr_waiting != 0;
+
+	if(queued) {
+		dequeue_group(crq, rq);
+	}
+	rq->vruntime += div_u64(ran_ns * SCHED_GROUP_WEIGHT_DEFAULT, READ_ONCE(rq->group->weight));
+	if(queued) {
+		enqueue_group(crq, rq);
+	}
+}
+
+/**
+	Function Name : enqueue_process
+	Function Type : Queue Helper
+	Description	  :	Method hands a waiting process to the policy of the
+					sub-queue of its group, once. A group that starts
+					waiting joins the tree of its CPU no earlier than the
+					groups already there, it earns no credit for the time
+					it had nothing to run. Caller must hold the run queue
+					spinlock.
+*/
+static void enqueue_process(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq;
+
+	if(!node->se.on_rq) {
+		rq = group_rq_of(node);
+		rq->policy->enqueue(rq, node);
+		node->se.on_rq = true;
+		if(rq->nr_waiting++ == 0) {
+			rq->vruntime = max(rq->vruntime, crq->min_vruntime);
+			enqueue_group(crq, rq);
+		}
+		/**The CPU has something to switch to again, its tick restarts.*/
+		if(crq->tick_stopped) {
+			WRITE_ONCE(crq->tick_stopped, false);
+			resched_process_queue_cpu(crq->cpu, false);
+		}
+	}
+}
+
+/**
+	Function Name : dequeue_process
+	Function Type : Queue Helper
+	Description	  :	Method takes a process out of the policy of the
+					sub-queue of its group if it is enqueued. A group left
+					without waiting processes leaves the tree of its CPU.
+					Caller must hold the run queue spinlock.
+*/
+static void dequeue_process(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq;
+
+	if(node->se.on_rq) {
+		rq = group_rq_of(node);
+		rq->policy->dequeue(rq, node);
+		node->se.on_rq = false;
+		if(--rq->nr_waiting == 0) {
+			dequeue_group(crq, rq);
+		}
+	}
+}
+
+/**
+	Function Name : sync_process_policy
+	Function Type : Queue Helper
+	Description	  :	Method keeps the policy in line with the process state,
+					only waiting processes are enqueued. Caller must hold
+					the run queue spinlock.
+*/
+static void sync_process_policy(struct proc_cpu_rq *crq, struct proc *node) {
+
+	if(node->state == eWaiting) {
+		enqueue_process(crq, node);
+	}
+	else {
+		dequeue_process(crq, node);
+	}
+}
+
+/**
+	Function Name : pick_next_process
+	Function Type : Queue Helper
+	Description	  :	Method returns the process to run next on the CPU, left
+					enqueued, or NULL. The group of smallest vruntime is
+					picked and its policy picks the process. The next groups
+					are only asked when the policy of a group has nothing
+					runnable, e.g. throttled reservations. Caller must hold
+					the run queue spinlock.
+*/
+static struct proc *pick_next_process(struct proc_cpu_rq *crq) {
+
+	struct rb_node *rb;
+	struct proc_rq *rq;
+	struct proc *next;
+
+	for(rb = rb_first_cached(&crq->groups); rb != NULL; rb = rb_next(rb)) {
+		rq = rb_entry(rb, struct proc_rq, group_node);
+		next = rq->policy->pick_next(rq);
+		if(next != NULL) {
+			return next;
+		}
+	}
+	return NULL;
+}
+
+/**
+	Function Name : fifo_enqueue_process
+	Function Type : Policy Hook
+	Description	  :	Enqueue hook of the built in FIFO policy, the process
+					waits at the tail. Exported for the list based policies.
+*/
+void fifo_enqueue_process(struct proc_rq *rq, struct proc *p) {
+
+	list_add_tail(&p->se.run_list, &rq->fifo);
+}
+
+/**
+	Function Name : fifo_dequeue_process
+	Function Type : Policy Hook
+	Description	  :	Dequeue hook of the built in FIFO policy.
+*/
+void fifo_dequeue_process(struct proc_rq *rq, struct proc *p) {
+
+	list_del_init(&p->se.run_list);
+}
+
+/**
+	Function Name : fifo_pick_next_process
+	Function Type : Policy Hook
+	Description	  :	Pick next hook of the built in FIFO policy, the process
+					waiting the longest.
+*/
+struct proc *fifo_pick_next_process(struct proc_rq *rq) {
+
+	return list_first_entry_or_null(&rq->fifo, struct proc, se.run_list);
+}
+
+/**
+	Built in FIFO policy. Used by the run queues until the scheduler
+	installs one of its policies and again once it is unloaded.
+*/
+static struct sched_policy_ops fifo_policy_ops = {
+	.name		= "fifo",
+	.owner		= THIS_MODULE,
+	.enqueue	= fifo_enqueue_process,
+	.dequeue	= fifo_dequeue_process,
+	.pick_next	= fifo_pick_next_process,
+};
+
+/**Policy installed on every sub-queue, given to the new groups. Changed under the policy mutex.*/
+static struct sched_policy_ops *queue_policy = &fifo_policy_ops;
+
+/**
+	Function Name : set_process_queue_policy
+	Function Type : Queue Function
+	Description	  :	Method installs the given policy on every sub-queue, or
+					the built in FIFO policy when ops is NULL. The processes
+					stay registered, each run queue dequeues its waiting
+					processes from the old policy and enqueues them in the
+					new one under its spinlock, the running ones keep
+					running. Must be called from process context.
+*/
+int set_process_queue_policy(struct sched_policy_ops *ops) {
+
+	struct proc_cpu_rq *crq;
+	struct proc_rq *rq;
+	struct proc_group *group;
+	struct proc *node;
+	void __percpu **areas;
+	void __percpu *old_area;
+	unsigned long flags;
+	unsigned int nr_groups = 0, i;
+	int cpu;
+
+	if(ops == NULL) {
+		ops = &fifo_policy_ops;
+	}
+	mutex_lock(&policy_mutex);
+	list_for_each_entry(group, &proc_groups, list) {
+		nr_groups++;
+	}
+	/**Allocating the zeroed per CPU data of the policy for every group before any run queue is touched.*/
+	areas = kcalloc(nr_groups, sizeof(*areas), GFP_KERNEL);
+	if(areas == NULL) {
+		mutex_unlock(&policy_mutex);
+		return -ENOMEM;
+	}
+	for(i = 0; ops->rq_priv_size != 0 && i < nr_groups; i++) {
+		areas[i] = __alloc_percpu(ops->rq_priv_size, __alignof__(u64));
+		if(areas[i] == NULL) {
+			mutex_unlock(&policy_mutex);
+			printk(KERN_ALERT "Process Queue ERROR:per CPU data of policy %s cannot be allocated.\n", ops->name);
+			while(i-- > 0) {
+				free_percpu(areas[i]);
+			}
+			kfree(areas);
+			return -ENOMEM;
+		}
+	}
+	for_each_possible_cpu(cpu) {
+		crq = per_cpu_ptr(&proc_rqs, cpu);
+		spin_lock_irqsave(&crq->lock, flags);
+		i = 0;
+		list_for_each_entry(group, &proc_groups, list) {
+			rq = per_cpu_ptr(group->rqs, cpu);
+			/**Emptying the old policy.*/
+			list_for_each_entry(node, &(rq->top.list), list) {
+				dequeue_process(crq, node);
+			}
+			if(rq->policy->exit_rq != NULL) {
+				rq->policy->exit_rq(rq);
+			}
+			/**Filling the new one with the waiting processes.*/
+			rq->policy = ops;
+			rq->policy_priv = areas[i] != NULL ? per_cpu_ptr(areas[i], cpu) : NULL;
+			if(ops->init_rq != NULL) {
+				ops->init_rq(rq);
+			}
+			list_for_each_entry(node, &(rq->top.list), list) {
+				sync_process_policy(crq, node);
+			}
+			i++;
+		}
+		spin_unlock_irqrestore(&crq->lock, flags);
+	}
+	/**No run queue refers to the old per CPU data anymore.*/
+	i = 0;
+	list_for_each_entry(group, &proc_groups, list) {
+		old_area = group->policy_priv_area;
+		group->policy_priv_area = areas[i];
+		areas[i++] = old_area;
+	}
+	queue_policy = ops;
+	mutex_unlock(&policy_mutex);
+	for(i = 0; i < nr_groups; i++) {
+		free_percpu(areas[i]);
+	}
+	kfree(areas);
+
+	printk(KERN_INFO "Process Queue policy set to %s\n", ops->name);
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : find_process_group
+	Function Type : Group Lookup
+	Description	  :	Method returns the group of the given name or NULL.
+					Caller must hold the policy mutex. Only used when a
+					group is named, the run queues reach the group of a
+					process through its node.
+*/
+static struct proc_group *find_process_group(const char *name) {
+
+	struct proc_group *group;
+
+	list_for_each_entry(group, &proc_groups, list) {
+		if(strcmp(group->name, name) == 0) {
+			return group;
+		}
+	}
+	return NULL;
+}
+
+/**
+	Function Name : alloc_process_group
+	Function Type : Group Helper
+	Description	  :	Method allocates a group with an empty sub-queue on
+					every possible CPU, each running the installed policy.
+					The group is not linked. Caller must hold the policy
+					mutex. Returns NULL if memory runs out.
+*/
+static struct proc_group *alloc_process_group(const char *name, unsigned int weight) {
+
+	struct proc_group *group;
+	struct proc_cpu_rq *crq;
+	struct proc_rq *rq;
+	unsigned long flags;
+	int cpu;
+
+	group = kzalloc(sizeof(*group), GFP_KERNEL);
+	if(group == NULL) {
+		return NULL;
+	}
+	strscpy(group->name, name, sizeof(group->name));
+	group->weight = weight;
+	atomic_set(&group->nr_procs, 0);
+	group->rqs = alloc_percpu(struct proc_rq);
+	if(group->rqs == NULL) {
+		kfree(group);
+		return NULL;
+	}
+	if(queue_policy->rq_priv_size != 0) {
+		group->policy_priv_area = __alloc_percpu(queue_policy->rq_priv_size, __alignof__(u64));
+		if(group->policy_priv_area == NULL) {
+			free_percpu(group->rqs);
+			kfree(group);
+			return NULL;
+		}
+	}
+	for_each_possible_cpu(cpu) {
+		crq = per_cpu_ptr(&proc_rqs, cpu);
+		rq = per_cpu_ptr(group->rqs, cpu);
+		INIT_LIST_HEAD(&rq->top.list);
+		/**Marking the head so RCU walkers can recognise it.*/
+		rq->top.pid = INVALID_PID;
+		rq->nr_procs = 0;
+		rq->curr = NULL;
+		rq->burst_sum_ns = 0;
+		rq->cpu = cpu;
+		INIT_LIST_HEAD(&rq->fifo);
+		rq->policy = queue_policy;
+		rq->policy_priv = group->policy_priv_area != NULL ? per_cpu_ptr(group->policy_priv_area, cpu) : NULL;
+		rq->group = group;
+		RB_CLEAR_NODE(&rq->group_node);
+		rq->vruntime = 0;
+		rq->nr_waiting = 0;
+		if(queue_policy->init_rq != NULL) {
+			spin_lock_irqsave(&crq->lock, flags);
+			queue_policy->init_rq(rq);
+			spin_unlock_irqrestore(&crq->lock, flags);
+		}
+	}
+	return group;
+}
+
+/**
+	Function Name : free_process_group
+	Function Type : Group Helper
+	Description	  :	Method releases an unlinked group without processes,
+					once no RCU walker can see it anymore. Caller must hold
+					the policy mutex.
+*/
+static void free_process_group(struct proc_group *group) {
+
+	struct proc_cpu_rq *crq;
+	struct proc_rq *rq;
+	unsigned long flags;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		crq = per_cpu_ptr(&proc_rqs, cpu);
+		rq = per_cpu_ptr(group->rqs, cpu);
+		if(rq->policy->exit_rq != NULL) {
+			spin_lock_irqsave(&crq->lock, flags);
+			rq->policy->exit_rq(rq);
+			spin_unlock_irqrestore(&crq->lock, flags);
+		}
+	}
+	free_percpu(group->policy_priv_area);
+	free_percpu(group->rqs);
+	kfree(group);
+}
+
+/**
+	Function Name : add_process_group
+	Function Type : Queue Function
+	Description	  :	Method creates a group of the given name and weight, or
+					changes the weight of the existing group of that name.
+					The weight is relative to SCHED_GROUP_WEIGHT_DEFAULT,
+					the weight of the default group. Must be called from
+					process context.
+*/
+int add_process_group(const char *name, unsigned int weight) {
+
+	struct proc_group *group;
+
+	if(*name == '\0' || strlen(name) >= SCHED_GROUP_NAME_MAX) {
+		printk(KERN_ALERT "Process Queue ERROR:group name must have 1 to %d characters.\n", SCHED_GROUP_NAME_MAX - 1);
+		return -EINVAL;
+	}
+	if(weight == 0 || weight > SCHED_GROUP_WEIGHT_MAX) {
+		printk(KERN_ALERT "Process Queue ERROR:group weight must be within [1, %d].\n", SCHED_GROUP_WEIGHT_MAX);
+		return -EINVAL;
+	}
+	mutex_lock(&policy_mutex);
+	group = find_process_group(name);
+	if(group != NULL) {
+		/**Reweighting, read without lock by the run queues.*/
+		WRITE_ONCE(total_group_weight, total_group_weight - group->weight + weight);
+		WRITE_ONCE(group->weight, weight);
+		mutex_unlock(&policy_mutex);
+		printk(KERN_INFO "Process Queue group %s weight set to %u\n", name, weight);
+		return 0;
+	}
+	group = alloc_process_group(name, weight);
+	if(group == NULL) {
+		mutex_unlock(&policy_mutex);
+		printk(KERN_ALERT "Process Queue ERROR:group %s cannot be allocated.\n", name);
+		return -ENOMEM;
+	}
+	list_add_tail_rcu(&group->list, &proc_groups);
+	WRITE_ONCE(total_group_weight, total_group_weight + weight);
+	mutex_unlock(&policy_mutex);
+
+	printk(KERN_INFO "Process Queue group %s added with weight %u\n", name, weight);
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : remove_process_group
+	Function Type : Queue Function
+	Description	  :	Method removes the group of the given name. Fails with
+					-EBUSY while processes are registered in it, and with
+					-EPERM for the default group. Must be called from
+					process context.
+*/
+int remove_process_group(const char *name) {
+
+	struct proc_group *group;
+
+	mutex_lock(&policy_mutex);
+	group = find_process_group(name);
+	if(group == NULL) {
+		mutex_unlock(&policy_mutex);
+		printk(KERN_ALERT "Process Queue ERROR:group %s does not exist.\n", name);
+		return -ENOENT;
+	}
+	if(group == default_group) {
+		mutex_unlock(&policy_mutex);
+		printk(KERN_ALERT "Process Queue ERROR:the default group cannot be removed.\n");
+		return -EPERM;
+	}
+	/**New members join under the policy mutex, old ones leave before their node is unlinked.*/
+	if(atomic_read(&group->nr_procs) != 0) {
+		mutex_unlock(&policy_mutex);
+		printk(KERN_ALERT "Process Queue ERROR:group %s still has processes.\n", name);
+		return -EBUSY;
+	}
+	list_del_rcu(&group->list);
+	WRITE_ONCE(total_group_weight, total_group_weight - group->weight);
+	/**Waiting for the run queues walking the group list.*/
+	synchronize_rcu();
+	free_process_group(group);
+	mutex_unlock(&policy_mutex);
+
+	printk(KERN_INFO "Process Queue group %s removed\n", name);
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : process_group_total_weight
+	Function Type : Queue Function
+	Description	  :	Method returns the sum of the weights of the groups. A
+					group gets at least its weight over this sum of any CPU
+					on which its processes wait. Lockless, the sum may change
+					meanwhile.
+*/
+unsigned int process_group_total_weight(void) {
+
+	return READ_ONCE(total_group_weight);
+}
+
+/**
+	Function Name : init_process_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for initializing a process queue.
+					The default group is created with the built in FIFO
+					policy.
+*/
+int init_process_queue(void) {
+
+	struct proc_cpu_rq *rq;
+	int cpu;
+
+	printk(KERN_INFO "Initializing the Process Queue...\n");
+	/**Initializing every run queue empty.*/
+	for_each_possible_cpu(cpu) {
+		rq = per_cpu_ptr(&proc_rqs, cpu);
+		spin_lock_init(&rq->lock);
+		rq->nr_procs = 0;
+		rq->curr = NULL;
+		rq->burst_sum_ns = 0;
+		rq->cpu = cpu;
+		rq->groups = RB_ROOT_CACHED;
+		rq->min_vruntime = 0;
+		INIT_LIST_HEAD(&rq->blocked);
+		init_irq_work(&rq->wake_work, wake_blocked_processes);
+		rq->cont_pid = INVALID_PID;
+		rq->stop_pid = INVALID_PID;
+		rq->gang_pull_pid = INVALID_PID;
+		spin_lock_init(&rq->enforce_lock);
+		INIT_LIST_HEAD(&rq->enforce_list);
+		rq->enforce_busy = NULL;
+		INIT_WORK(&rq->enforce_work, enforce_queued_changes);
+	}
+	/**Initializing empty pid and gang hash indexes.*/
+	hash_init(proc_hash);
+	hash_init(gang_hash);
+	/**Creating the group of the processes registered without one.*/
+	mutex_lock(&policy_mutex);
+	default_group = alloc_process_group(SCHED_GROUP_DEFAULT, SCHED_GROUP_WEIGHT_DEFAULT);
+	if(default_group == NULL) {
+		mutex_unlock(&policy_mutex);
+		printk(KERN_ERR "Process Queue ERROR:default group cannot be allocated\n");
+		return -ENOMEM;
+	}
+	list_add_tail_rcu(&default_group->list, &proc_groups);
+	WRITE_ONCE(total_group_weight, SCHED_GROUP_WEIGHT_DEFAULT);
+	mutex_unlock(&policy_mutex);
+	return 0;
+}
+
+/**
+	Function Name : release_process_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for releasing a process queue. Every
+					process is removed, its task continued and given its
+					CPU affinity back as on removal, then every group. Must be called from process
+					context.
+*/
+int release_process_queue(void) {
+		 	
+	struct proc *node;
+	struct proc_group *group, *gtmp;
+	struct proc_cpu_rq *rq;
+	struct pid *pid_ref;
+	unsigned long flags;
+	bool detach;
+	int cpu, home_cpu;
+
+	printk(KERN_INFO "Releasing Process Queue...\n");
+	mutex_lock(&policy_mutex);
+	for_each_possible_cpu(cpu) {
+		rq = per_cpu_ptr(&proc_rqs, cpu);
+		/**
+			Removing the nodes one by one, the task of each is given back
+			outside the run queue spinlock as it may sleep.
+		*/
+		for(;;) {
+			spin_lock_irqsave(&rq->lock, flags);
+			node = NULL;
+			list_for_each_entry(group, &proc_groups, list) {
+				node = list_first_entry_or_null(&(per_cpu_ptr(group->rqs, cpu)->top.list), struct proc, list);
+				if(node != NULL) {
+					break;
+				}
+			}
+			if(node == NULL) {
+				spin_unlock_irqrestore(&rq->lock, flags);
+				break;
+			}
+			pid_ref = get_pid(node->pid_ref);
+			detach = task_enforce->per_thread || READ_ONCE(node->gang->nr_members) == 1;
+			home_cpu = node->gang->home_cpu;
+			unlink_process_node(rq, node);
+			spin_unlock_irqrestore(&rq->lock, flags);
+			/**Neither stopped, frozen, parked nor pinned once the module is gone.*/
+			release_task_of_process(rq, pid_ref, home_cpu, detach);
+			put_pid(pid_ref);
+		}
+	}
+	/**Removing the groups, now empty, once no run queue walks them.*/
+	list_for_each_entry_safe(group, gtmp, &proc_groups, list) {
+		list_del_rcu(&group->list);
+		synchronize_rcu();
+		free_process_group(group);
+	}
+	default_group = NULL;
+	WRITE_ONCE(total_group_weight, 0);
+	mutex_unlock(&policy_mutex);
+	/**Waiting for the task state changes still being applied.*/
+	for_each_possible_cpu(cpu) {
+		flush_task_enforce(per_cpu_ptr(&proc_rqs, cpu));
+	}
+	/**Function returns success.*/
+	return 0;
+}
+
+/**
+	Function Name : admit_process_node
+	Function Type : Queue Helper
+	Description	  :	Method asks the policy of the sub-queue of the group of a
+					new node on the CPU of the given run queue to admit it,
+					before the task is touched. An admitted node is either
+					linked by insert_process_node or given back through
+					cancel_process_admission. Returns the error of the
+					admit hook, -EBUSY when the run queue has no room left
+					for the process. Policy mutex must be held.
+*/
+static int admit_process_node(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq;
+	unsigned long flags;
+	int ret = 0;
+
+	node->cpu = crq->cpu;
+	rq = group_rq_of(node);
+	spin_lock_irqsave(&crq->lock, flags);
+	if(rq->policy->admit != NULL) {
+		ret = rq->policy->admit(rq, node);
+	}
+	spin_unlock_irqrestore(&crq->lock, flags);
+	return ret;
+}
+
+/**
+	Function Name : cancel_process_admission
+	Function Type : Queue Helper
+	Description	  :	Method gives back to its policy the room of an admitted
+					node that is not linked after all. Caller must hold the
+					run queue spinlock.
+*/
+static void cancel_process_admission(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq = group_rq_of(node);
+
+	if(rq->policy->admit != NULL && rq->policy->task_dead != NULL) {
+		rq->policy->task_dead(rq, node);
+	}
+}
+
+/**
+	Function Name : insert_process_node
+	Function Type : Queue Helper
+	Description	  :	Method links a new node, admitted and pinned to the CPU
+					of the given run queue already. A free CPU dispatches it
+					at once, without waiting for its tick, as does a busy
+					one whose policy lets it preempt. Returns -ESRCH if the
+					task is exiting or gone before it could be stopped, its
+					admission then given back and the node left unlinked.
+					Must be called from process context with the policy
+					mutex held.
+*/
+static int insert_process_node(struct proc_cpu_rq *crq, struct proc *node) {
+
+	unsigned long flags;
+	bool busy;
+
+	/**
+		Acquiring the run queue spinlock. The lock is usable from atomic
+		context and cannot be interrupted by a signal.
+	*/
+	spin_lock_irqsave(&crq->lock, flags);
+
+	/**
+		Check the task is not exiting. Checked under the run queue lock, a
+		task exiting later finds the node through the exit probe.
+	*/
+	if(is_task_exists(node->pid_ref) == eTaskStatusTerminated) {
+		cancel_process_admission(crq, node);
+		spin_unlock_irqrestore(&crq->lock, flags);
+		printk(KERN_ALERT "Process Queue ERROR:Process %d is exiting.\n", node->pid);
+		return -ESRCH;
+	}
+	/**The changes of the gang are ordered on the CPU of its first member.*/
+	spin_lock(&node->gang->lock);
+	if(node->gang->home_cpu < 0) {
+		node->gang->home_cpu = crq->cpu;
+	}
+	spin_unlock(&node->gang->lock);
+	/**
+		Make the task level alteration therefore the process pauses its execution since in wait state,
+		unless its gang runs. Done before the node is visible, so a task gone meanwhile is turned
+		down like an exiting one.
+	*/
+	if(change_task_of_process(node, eWaiting) == eTaskStatusTerminated) {
+		cancel_process_admission(crq, node);
+		spin_unlock_irqrestore(&crq->lock, flags);
+		printk(KERN_ALERT "Process Queue ERROR:Process %d is gone.\n", node->pid);
+		return -ESRCH;
+	}
+	spin_lock(&hash_lock);
+	/**Index the new process by its pid.*/
+	hash_add_rcu(proc_hash, &node->hnode, node->pid);
+	spin_unlock(&hash_lock);
+
+	/**Set the new process as a tail to the previous top of the list of its group.*/
+	attach_process_node(crq, node);
+	/**Joining the gang of its thread group.*/
+	spin_lock(&node->gang->lock);
+	list_add_tail(&node->gang_list, &node->gang->members);
+	spin_unlock(&node->gang->lock);
+	/**Handing the waiting process to the policy of the sub-queue.*/
+	enqueue_process(crq, node);
+	trace_process_sched_register(node->pid, crq->cpu, node->group->name, node->attr.runtime_ns);
+	/**Dispatching the process at once if the CPU is free or runs a process it preempts.*/
+	check_preempt_process(crq, node);
+	busy = crq->curr != NULL;
+
+	/**Releasing the run queue spinlock.*/
+	spin_unlock_irqrestore(&crq->lock, flags);
+
+	/**The process waits behind a running one, a CPU with a stopped tick may take it.*/
+	if(busy) {
+		kick_idle_process_queue(crq->cpu);
+	}
+	return 0;
+}
+
+/**
+	Function Name : add_process_to_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for adding a process into a queue.
+					The process is placed on the least loaded CPU and
+					pinned to it. Must be called from process context.
+*/
+int add_process_to_queue(int pid) {
+
+	return add_process_to_queue_attr(pid, NULL);
+}
+
+/**
+	Function Name : add_process_to_queue_attr
+	Function Type : Queue Function
+	Description	  :	Method is invoked for adding a process with scheduling
+					attributes into a queue, NULL meaning none. Given the
+					leader of a thread group, every thread of the group is
+					added with the same attributes and the method succeeds
+					if any of them was. The threads run as a gang. The pid
+					is numbered in the initial pid namespace. Must be
+					called from process context.
+*/
+int add_process_to_queue_attr(int pid, const struct proc_sched_attr *attr) {
+
+	struct task_struct *task = NULL, *t;
+	struct pid *pid_ref;
+	pid_t *tids = NULL;
+	int nr = 0, max = 0, i, ret, first_err = 0;
+	bool added = false;
+
+	pid_ref = find_get_global_pid(pid);
+	if(pid_ref != NULL) {
+		task = get_pid_task(pid_ref, PIDTYPE_PID);
+		put_pid(pid_ref);
+	}
+	if(task != NULL) {
+		max = thread_group_leader(task) ? get_nr_threads(task) : 0;
+		if(max <= 1) {
+			put_task_struct(task);
+			task = NULL;
+		}
+	}
+	/**A single thread, or a pid that is not a leader, is added on its own.*/
+	if(task == NULL) {
+		return add_thread_to_queue(pid, attr);
+	}
+	tids = kmalloc_array(max, sizeof(*tids), GFP_KERNEL);
+	if(tids == NULL) {
+		put_task_struct(task);
+		printk(KERN_ALERT "Process Queue ERROR:kmalloc_array function failed from add_process_to_queue_attr function.");
+		return -ENOMEM;
+	}
+	/**Collecting the threads first, registration sleeps. Threads created meanwhile are left to follow_fork.*/
+	rcu_read_lock();
+	for_each_thread(task, t) {
+		if(nr == max) {
+			break;
+		}
+		tids[nr++] = task_pid_nr(t);
+	}
+	rcu_read_unlock();
+	put_task_struct(task);
+	for(i = 0; i < nr; i++) {
+		ret = add_thread_to_queue(tids[i], attr);
+		if(ret == 0) {
+			added = true;
+		}
+		else if(first_err == 0) {
+			first_err = ret;
+		}
+	}
+	kfree(tids);
+	return added ? 0 : first_err;
+}
+
+/**
+	Function Name : add_thread_to_queue
+	Function Type : Queue Helper
+	Description	  :	Method adds a single thread with scheduling attributes
+					into a queue, NULL meaning none. The thread joins the
+					gang of its thread group and is placed on the least
+					loaded CPU no other member of the gang is on. If the
+					policy of that CPU turns it down for lack of room, the
+					other CPUs are tried in order. A thread pinned by its
+					attributes goes to its CPU only, -EINVAL if that CPU
+					takes no process. The thread joins the
+					group named in the attributes, which must exist, or the
+					default group. The task is handed to the enforcement
+					backend and pinned to its CPU only once it is known to
+					be new and admitted, so a failed registration leaves a
+					registered task alone. Must be called from process
+					context.
+*/
+static int add_thread_to_queue(int pid, const struct proc_sched_attr *attr) {
+
+	struct proc_cpu_rq *rq, *first;
+	struct proc *new_process;
+	struct proc_group *group;
+	unsigned long flags;
+	bool registered;
+	int cpu, ret;
+
+	/**Check the attributes describe a feasible reservation.*/
+	if(attr != NULL && attr->runtime_ns != 0) {
+		if(attr->period_ns == 0 || attr->runtime_ns > attr->deadline_ns || attr->deadline_ns > attr->period_ns) {
+			printk(KERN_ALERT "Process Queue ERROR:Process %d needs runtime <= deadline <= period.\n", pid);
+			return -EINVAL;
+		}
+	}
+	/**Allocating space for the newly registered process.*/
+	new_process = kmem_cache_alloc(proc_cache, GFP_KERNEL);
+	/**Check if the kmem_cache_alloc call was successful or not.*/	
+	if(!new_process) {
+
+		printk(KERN_ALERT "Process Queue ERROR:kmem_cache_alloc function failed from add_process_to_queue function.");
+		/** Add process to queue error.*/
+		return -ENOMEM;
+	}
+	/**Accounting the allocation.*/
+	atomic_long_inc(&proc_alloc_count);
+	/**Setting the process id to the process info node new_process*/
+	new_process->pid = pid;
+	/**
+		Resolving the pid once in the initial namespace, the interfaces
+		translate the pid of the registering process. Every later task
+		level operation goes through this reference.
+	*/
+	new_process->pid_ref = find_get_global_pid(pid);
+	if(new_process->pid_ref == NULL) {
+		kmem_cache_free(proc_cache, new_process);
+		printk(KERN_ALERT "Process Queue ERROR:Process %d does not exist.\n", pid);
+		return -ESRCH;
+	}
+	/**
+		Registrations are serialized by the policy mutex, from the lookup of
+		the group to the link of the node. No other one can register the pid
+		meanwhile, and the policy cannot change under an admitted node.
+	*/
+	mutex_lock(&policy_mutex);
+	/**Resolving the group once, the group cannot be removed while it counts the process.*/
+	group = attr != NULL && attr->group[0] != '\0' ? find_process_group(attr->group) : default_group;
+	if(group == NULL) {
+		mutex_unlock(&policy_mutex);
+		free_process_node(new_process);
+		printk(KERN_ALERT "Process Queue ERROR:group %s of Process %d does not exist.\n", attr->group, pid);
+		return -ENOENT;
+	}
+	/**Check if the process is already registered before the task is touched, the index holds one node per pid.*/
+	rcu_read_lock();
+	registered = find_process_in_queue(pid) != NULL;
+	rcu_read_unlock();
+	if(registered) {
+		mutex_unlock(&policy_mutex);
+		free_process_node(new_process);
+		printk(KERN_ALERT "Process Queue ERROR:Process %d is already in the Process Queue.\n", pid);
+		return -EEXIST;
+	}
+	/**Joining the gang of its thread group.*/
+	new_process->gang = get_process_gang(new_process->pid_ref);
+	if(new_process->gang == NULL) {
+		mutex_unlock(&policy_mutex);
+		free_process_node(new_process);
+		printk(KERN_ALERT "Process Queue ERROR:gang of Process %d cannot be found.\n", pid);
+		return -ESRCH;
+	}
+	INIT_LIST_HEAD(&new_process->gang_list);
+	new_process->gang_on = false;
+	init_task_enforce(&new_process->enforce);
+	/**Setting the process state to the process info node new_process as waiting.*/
+	new_process->state = eWaiting;
+	/**No slice measured yet.*/
+	new_process->dispatch_cputime_ns = 0;
+	new_process->last_burst_ns = 0;
+	/**Copying the scheduling attributes, all zero without a reservation.*/
+	if(attr != NULL) {
+		new_process->attr = *attr;
+	}
+	else {
+		memset(&new_process->attr, 0, sizeof(new_process->attr));
+	}
+	new_process->group = group;
+	/**Not known to any policy yet.*/
+	memset(&new_process->se, 0, sizeof(new_process->se));
+	memset(&new_process->stats, 0, sizeof(new_process->stats));
+	new_process->stats.registered_ns = new_process->stats.stamp_ns = ktime_get_ns();
+	INIT_LIST_HEAD(&new_process->se.run_list);
+	INIT_LIST_HEAD(&new_process->block_list);
+	RB_CLEAR_NODE(&new_process->se.run_node);
+
+	/**Choosing the run queue, the CPU the process is pinned to or the least loaded one first.*/
+	if(new_process->attr.pinned) {
+		if(new_process->attr.cpu >= nr_cpu_ids || !cpu_online(new_process->attr.cpu) || !is_sched_cpu(new_process->attr.cpu)) {
+			mutex_unlock(&policy_mutex);
+			printk(KERN_ALERT "Process Queue ERROR:CPU %u of Process %d takes no process.\n", new_process->attr.cpu, pid);
+			put_process_gang(new_process->gang);
+			free_process_node(new_process);
+			return -EINVAL;
+		}
+		first = rq = per_cpu_ptr(&proc_rqs, new_process->attr.cpu);
+	}
+	else {
+		first = rq = pick_rq_for_new_process(new_process->gang);
+	}
+	ret = admit_process_node(first, new_process);
+	/**A pinned process is not admitted anywhere else.*/
+	if(ret == -EBUSY && !new_process->attr.pinned) {
+		for_each_online_cpu(cpu) {
+			rq = per_cpu_ptr(&proc_rqs, cpu);
+			if(rq == first || !is_sched_cpu(cpu)) {
+				continue;
+			}
+			ret = admit_process_node(rq, new_process);
+			if(ret != -EBUSY) {
+				break;
+			}
+		}
+	}
+	if(ret != 0) {
+		mutex_unlock(&policy_mutex);
+		if(ret == -EBUSY) {
+			printk(KERN_ALERT "Process Queue ERROR:Process %d is not admitted by any CPU.\n", pid);
+		}
+		put_process_gang(new_process->gang);
+		free_process_node(new_process);
+		return ret;
+	}
+	/**Letting the enforcement backend turn the task down before it is stopped.*/
+	if(task_enforce->attach != NULL) {
+		ret = task_enforce->attach(new_process->pid_ref);
+		if(ret != 0) {
+			spin_lock_irqsave(&rq->lock, flags);
+			cancel_process_admission(rq, new_process);
+			spin_unlock_irqrestore(&rq->lock, flags);
+			mutex_unlock(&policy_mutex);
+			put_process_gang(new_process->gang);
+			free_process_node(new_process);
+			return ret;
+		}
+	}
+	/**Pinning the task to the CPU before it is visible.*/
+	task_affinity_change(new_process->pid_ref, cpumask_of(rq->cpu));
+	/**The group counts the process before the policy mutex lets it be removed.*/
+	atomic_inc(&group->nr_procs);
+	ret = insert_process_node(rq, new_process);
+	if(ret != 0) {
+		atomic_dec(&group->nr_procs);
+	}
+	mutex_unlock(&policy_mutex);
+	if(ret != 0) {
+		/**Unpinning the task, it was never visible.*/
+		task_affinity_change(new_process->pid_ref, cpu_possible_mask);
+		if(task_enforce->detach != NULL) {
+			task_enforce->detach(new_process->pid_ref);
+		}
+		put_process_gang(new_process->gang);
+		free_process_node(new_process);
+		return ret;
+	}
+
+	pr_debug("Adding the given Process %d to the  Process Queue of CPU %d, group %s...\n", pid, new_process->cpu, group->name);
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : remove_process_from_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for removing a given process 
+					from the queue. The task gets its CPU affinity back,
+					and is continued and detached from the enforcement
+					backend unless other threads of its group remain.
+					Returns -ESRCH if the pid is not registered. Must be
+					called from process context.
+*/
+int remove_process_from_queue(int pid) {
+		 	
+	struct proc *node;
+	struct proc_cpu_rq *rq;
+	struct pid *pid_ref = NULL;
+	unsigned long flags;
+	bool detach;
+	int home_cpu;
+
+	/**Looking up the process with provided pid in the index and removing it.*/	
+	node = lock_process_in_queue(pid, &rq, &flags);
+	if(node != NULL) {
+		pr_debug("Removing the given Process %d from the  Process Queue...\n", pid);
+		/**Keeping the pid alive for the affinity restore below.*/
+		pid_ref = get_pid(node->pid_ref);
+		/**A backend acting on thread groups keeps holding the group while other threads are registered.*/
+		detach = task_enforce->per_thread || READ_ONCE(node->gang->nr_members) == 1;
+		home_cpu = node->gang->home_cpu;
+		unlink_process_node(rq, node);
+		/**Releasing the run queue spinlock.*/
+		spin_unlock_irqrestore(&rq->lock, flags);
+		/**Giving the task back, it is no longer scheduled by this module.*/
+		release_task_of_process(rq, pid_ref, home_cpu, detach);
+		put_pid(pid_ref);
+	}
+	else {
+		/**The process was reaped or never registered.*/
+		return -ESRCH;
+	}
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : rotate_process_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for giving the given process, normally
+					the one that just ran, back to the policy of its run
+					queue in the waiting state. With the FIFO based policies
+					it waits at the tail. The node is reused as is, no
+					memory is freed or allocated.
+*/
+int rotate_process_queue(int pid) {
+
+	struct proc *node;
+	struct proc_cpu_rq *rq;
+	unsigned long flags;
+
+	node = lock_process_in_queue(pid, &rq, &flags);
+	if(node == NULL) {
+		/**The process was reaped or never registered.*/
+		return -ESRCH;
+	}
+	/**Setting the process state as waiting and requeueing it in the policy.*/
+	list_del_init(&node->block_list);
+	account_process_state(node, ktime_get_ns());
+	node->state = eWaiting;
+	if(rq->curr == node) {
+		set_curr_process(rq, NULL);
+	}
+	dequeue_process(rq, node);
+	enqueue_process(rq, node);
+	/**Make the task level alteration therefore the process pauses its execution since in wait state.*/
+	change_task_of_process(node, eWaiting);
+	/**Releasing the run queue spinlock.*/
+	spin_unlock_irqrestore(&rq->lock, flags);
+
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : remove_terminated_processes_from_queue
+	Function Type : Queue Job
+	Description	  :	Method is invoked for removing all terminated processes
+					from the queue. Processes whose task no longer exists
+					are treated as terminated as well.
+*/
+int remove_terminated_processes_from_queue(void) {
+		 	
+	struct proc_cpu_rq *rq;
+	unsigned long flags;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		rq = per_cpu_ptr(&proc_rqs, cpu);
+		spin_lock_irqsave(&rq->lock, flags);
+		reap_terminated_processes(rq, NULL);
+		spin_unlock_irqrestore(&rq->lock, flags);
+	}
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : change_process_state_in_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for changing the process state 
+					for a given process in the queue.
+*/
+int change_process_state_in_queue(int pid, int changeState) {
+		 	
+	struct proc *node, *tmp;
+	struct proc_group *group;
+	struct proc_cpu_rq *rq;
+	unsigned long flags;
+	int cpu;
+
+	/**Enumeration to expect the task_status change function call.*/
+	enum process_state ret_process_change_status = changeState;
+
+	/**Check if all registered PIDs are modified for state*/
+	if(pid == ALL_REG_PIDS) {
+		for_each_possible_cpu(cpu) {
+			rq = per_cpu_ptr(&proc_rqs, cpu);
+			spin_lock_irqsave(&rq->lock, flags);
+			rcu_read_lock();
+			/**Iterate over all the processes in the queue and set the status the provided status.*/
+			for_each_process_group(group) {
+				list_for_each_entry_safe(node, tmp, &(per_cpu_ptr(group->rqs, cpu)->top.list), list) {
+			
+					pr_debug("Updating the process state the Process %d in  Process Queue...\n", node->pid);
+					/**Update the state to the provided state.*/
+					list_del_init(&node->block_list);
+					account_process_state(node, ktime_get_ns());
+					node->state = changeState;
+					/**Check if the task associated with the iterated node still exists or not.*/
+					if(change_task_of_process(node, node->state)==eTaskStatusTerminated) {
+						node->state = eTerminated;
+					}
+					/**A terminated process leaves the queue at once.*/
+					if(node->state == eTerminated) {
+						reap_process_node(rq, node);
+						continue;
+					}
+					/**Keeping the running slot and the policy in line with the state.*/
+					if(node->state != eRunning && rq->curr == node) {
+						set_curr_process(rq, NULL);
+					}
+					if(node->state == eBlocked) {
+						list_add_tail(&node->block_list, &rq->blocked);
+					}
+					sync_process_policy(rq, node);
+				}
+			}
+			rcu_read_unlock();
+			spin_unlock_irqrestore(&rq->lock, flags);
+		}
+	}
+	else {
+		/**
+			Look up the provided process in the index. Other processes are
+			not visited here, dead tasks are removed by the exit probe.
+		*/
+		node = lock_process_in_queue(pid, &rq, &flags);
+		if(node != NULL) {
+				
+			pr_debug("Updating the process state the Process %d in  Process Queue...\n", pid);
+			/**Update the state to the provided state.*/
+			list_del_init(&node->block_list);
+			account_process_state(node, ktime_get_ns());
+			node->state = changeState;
+			/**Check if the task associated with the node still exists or not.*/
+			if(change_task_of_process(node, node->state)==eTaskStatusTerminated) {
+				node->state = eTerminated;
+				/**Return value updated to notify that the requested process is already terminated.*/
+				ret_process_change_status = eTerminated;
+			}
+			/**Keeping the running slot and the policy in line with the state, a terminated process leaves the queue at once.*/
+			if(node->state == eTerminated) {
+				reap_process_node(rq, node);
+			}
+			else if(node->state == eRunning) {
+				set_curr_process(rq, node);
+			}
+			else if(rq->curr == node) {
+				set_curr_process(rq, NULL);
+			}
+			if(node->state == eBlocked) {
+				list_add_tail(&node->block_list, &rq->blocked);
+			}
+			if(node->state != eTerminated) {
+				sync_process_policy(rq, node);
+			}
+			/**Releasing the run queue spinlock.*/
+			spin_unlock_irqrestore(&rq->lock, flags);
+		}
+	}
+
+	/**Return the process status change associated with the internal call to task status change method.*/
+	return ret_process_change_status;
+}
+
+
+/**
+	Function Name : print_process_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for printing the process queue.
+					Lock free, the run queues are walked under RCU.
+*/
+int print_process_queue(void) {
+			
+	struct proc *tmp;
+	struct proc_group *group;
+	int cpu;
+
+	pr_debug("Process Queue: \n");
+	/**Entering the RCU read side, writers are not blocked.*/
+	rcu_read_lock();
+	for_each_online_cpu(cpu) {
+		for_each_process_group(group) {
+			/**Iterate over the sub-queue of the group and print each process id.*/
+			for_each_process_in_rq_rcu(tmp, per_cpu_ptr(group->rqs, cpu)) {
+			
+				if(tmp->attr.runtime_ns != 0) {
+					pr_debug("CPU %d Group %s Process ID: %d runtime %llu ns period %llu ns deadline %llu ns missed deadlines %lu\n",
+						cpu, group->name, tmp->pid, tmp->attr.runtime_ns, tmp->attr.period_ns, tmp->attr.deadline_ns, READ_ONCE(tmp->se.nr_missed));
+				}
+				else {
+					pr_debug("CPU %d Group %s Process ID: %d\n", cpu, group->name, tmp->pid);
+				}
+			}
+		}
+	}
+	rcu_read_unlock();
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : apply_task_enforce
+	Function Type : Queue Helper
+	Description	  :	Method has the enforcement backend run or stop the task
+					of a process on the given cpu, and accounts the time it
+					took to the given run queue. Called by one context at a
+					time per run queue, under its spinlock or from its
+					enforcement work.
+*/
+static void apply_task_enforce(struct proc_cpu_rq *crq, struct pid *pid_ref, int cpu, enum process_state state) {
+
+	u64 start = ktime_get_ns(), spent;
+	int ret;
+
+	ret = state == eRunning ? task_enforce->run(pid_ref, cpu) : task_enforce->stop(pid_ref, cpu);
+	spent = ktime_get_ns() - start;
+	if(ret != 0) {
+		pr_debug("Task %d cannot be %s, error %d\n", pid_nr(pid_ref), state == eRunning ? "run" : "stopped", ret);
+	}
+	WRITE_ONCE(crq->nr_enforced, crq->nr_enforced + 1);
+	WRITE_ONCE(crq->enforce_sum_ns, crq->enforce_sum_ns + spent);
+	if(spent > crq->enforce_max_ns) {
+		WRITE_ONCE(crq->enforce_max_ns, spent);
+	}
+}
+
+/**
+	Function Name : init_task_enforce
+	Function Type : Queue Helper
+	Description	  :	Method initializes the pending change of a process or a
+					gang, none.
+*/
+static void init_task_enforce(struct enforce_pending *pend) {
+
+	INIT_LIST_HEAD(&pend->list);
+	pend->rq = NULL;
+	pend->pid_ref = NULL;
+}
+
+/**
+	Function Name : queue_task_enforce
+	Function Type : Queue Helper
+	Description	  :	Method queues a task state change for the enforcement
+					work of the given run queue, for a backend that sleeps.
+					A target whose previous change is pending or being
+					applied stays with the run queue of that change, so its
+					changes are applied in order. A pending change is
+					replaced by the new one, which keeps its place, so no
+					change is lost whatever their rate. Interrupts must be
+					disabled, and the changes of a target serialized by the
+					caller through the run queue spinlock of the process or
+					the gang spinlock.
+*/
+static void queue_task_enforce(struct proc_cpu_rq *crq, struct enforce_pending *pend, struct pid *pid_ref, enum process_state state) {
+
+	struct proc_cpu_rq *owner = pend->rq;
+
+	/**Staying with the run queue of a change not applied yet.*/
+	if(owner != NULL) {
+		spin_lock(&owner->enforce_lock);
+		if(list_empty(&pend->list) && owner->enforce_busy != pend) {
+			spin_unlock(&owner->enforce_lock);
+			owner = NULL;
+		}
+	}
+	if(owner == NULL) {
+		owner = crq;
+		spin_lock(&owner->enforce_lock);
+	}
+	if(!list_empty(&pend->list)) {
+		/**Only the latest state matters, the earlier one is replaced in place.*/
+		if(pend->pid_ref != pid_ref) {
+			put_pid(pend->pid_ref);
+			pend->pid_ref = get_pid(pid_ref);
+		}
+		WRITE_ONCE(owner->nr_enforce_coalesced, owner->nr_enforce_coalesced + 1);
+	}
+	else {
+		pend->pid_ref = get_pid(pid_ref);
+		pend->rq = owner;
+		list_add_tail(&pend->list, &owner->enforce_list);
+	}
+	pend->state = state;
+	pend->cpu = crq->cpu;
+	spin_unlock(&owner->enforce_lock);
+	queue_work_on(owner->cpu, system_highpri_wq, &owner->enforce_work);
+}
+
+/**
+	Function Name : cancel_task_enforce
+	Function Type : Queue Helper
+	Description	  :	Method drops the change pending for a process or gang
+					about to be released. A change being applied goes on,
+					it no longer refers to the target. Interrupts must be
+					disabled.
+*/
+static void cancel_task_enforce(struct enforce_pending *pend) {
+
+	struct proc_cpu_rq *owner = pend->rq;
+
+	if(owner == NULL) {
+		return;
+	}
+	spin_lock(&owner->enforce_lock);
+	if(!list_empty(&pend->list)) {
+		list_del_init(&pend->list);
+		put_pid(pend->pid_ref);
+		pend->pid_ref = NULL;
+	}
+	spin_unlock(&owner->enforce_lock);
+}
+
+/**
+	Function Name : enforce_queued_changes
+	Function Type : Work Function
+	Description	  :	Work applying the task state changes pending on its run
+					queue, oldest first. The spinlock is only held to take
+					a change. The target is not touched once its change is
+					taken, it may be released meanwhile.
+*/
+static void enforce_queued_changes(struct work_struct *work) {
+
+	struct proc_cpu_rq *crq = container_of(work, struct proc_cpu_rq, enforce_work);
+	struct enforce_pending *pend;
+	struct pid *pid_ref = NULL;
+	enum process_state state = eWaiting;
+	unsigned long flags;
+	int cpu = crq->cpu;
+
+	for(;;) {
+		spin_lock_irqsave(&crq->enforce_lock, flags);
+		pend = list_first_entry_or_null(&crq->enforce_list, struct enforce_pending, list);
+		if(pend != NULL) {
+			list_del_init(&pend->list);
+			/**Taking the reference over, a new change of the target queues behind this one.*/
+			pid_ref = pend->pid_ref;
+			pend->pid_ref = NULL;
+			state = pend->state;
+			cpu = pend->cpu;
+		}
+		crq->enforce_busy = pend;
+		spin_unlock_irqrestore(&crq->enforce_lock, flags);
+		if(pend == NULL) {
+			break;
+		}
+		apply_task_enforce(crq, pid_ref, cpu, state);
+		put_pid(pid_ref);
+		cond_resched();
+	}
+}
+
+/**
+	Function Name : flush_task_enforce
+	Function Type : Queue Helper
+	Description	  :	Method waits until the state changes queued on the given
+					run queue are applied, so that a change made outside
+					the queue is not undone by an older one. Must be called
+					from process context.
+*/
+static void flush_task_enforce(struct proc_cpu_rq *crq) {
+
+	if(task_enforce->sleeps) {
+		flush_work(&crq->enforce_work);
+	}
+}
+
+/**
+	Function Name : release_task_of_process
+	Function Type : Queue Helper
+	Description	  :	Method gives the task of a process just unlinked back to
+					the kernel once its queued state changes are applied,
+					on the given run queue and on the home CPU of its gang.
+					The task gets its CPU affinity back. With detach, i.e.
+					when the backend holds no other thread of its group,
+					the task is continued and detached from the backend,
+					so that no stopped task or frozen cgroup is left
+					behind. Must be called from process context.
+*/
+static void release_task_of_process(struct proc_cpu_rq *crq, struct pid *pid_ref, int home_cpu, bool detach) {
+
+	flush_task_enforce(crq);
+	if(home_cpu != crq->cpu) {
+		flush_task_enforce(per_cpu_ptr(&proc_rqs, home_cpu));
+	}
+	if(detach) {
+		task_enforce->run(pid_ref, crq->cpu);
+	}
+	task_affinity_change(pid_ref, cpu_possible_mask);
+	if(detach && task_enforce->detach != NULL) {
+		task_enforce->detach(pid_ref);
+	}
+}
+
+/**
+	Function Name : lat_hist_add
+	Function Type : Queue Helper
+	Description	  :	Method counts a latency in its log2 bucket. O(1).
+*/
+static void lat_hist_add(struct lat_hist *h, u64 ns) {
+
+	unsigned int bucket = ns > 1 ? min_t(unsigned int, ilog2(ns), LAT_HIST_BUCKETS - 1) : 0;
+
+	WRITE_ONCE(h->buckets[bucket], h->buckets[bucket] + 1);
+	WRITE_ONCE(h->count, h->count + 1);
+	if(ns > h->max_ns) {
+		WRITE_ONCE(h->max_ns, ns);
+	}
+}
+
+/**
+	Function Name : lat_hist_percentile
+	Function Type : Queue Helper
+	Description	  :	Method returns the upper bound of the bucket holding
+					the given percentile of count latencies, capped by the
+					longest latency. 0 for an empty histogram.
+*/
+static u64 lat_hist_percentile(const struct lat_hist *h, unsigned long count, unsigned int pct) {
+
+	unsigned long rank = DIV_ROUND_UP(count * pct, 100), seen = 0;
+	unsigned int bucket;
+
+	for(bucket = 0; bucket < LAT_HIST_BUCKETS && count != 0; bucket++) {
+		seen += READ_ONCE(h->buckets[bucket]);
+		if(seen >= rank) {
+			return min_t(u64, 2ULL << bucket, READ_ONCE(h->max_ns));
+		}
+	}
+	return READ_ONCE(h->max_ns);
+}
+
+/**
+	Function Name : print_lat_hist
+	Function Type : Queue Helper
+	Description	  :	Method writes a latency histogram as one line, its
+					count, p50, p99 and max in ns followed by its buckets.
+*/
+static void print_lat_hist(struct seq_file *m, const char *name, const char *cpu, const struct lat_hist *h) {
+
+	unsigned long count = READ_ONCE(h->count);
+	unsigned int bucket;
+
+	seq_printf(m, "%s %s %lu %llu %llu %llu", name, cpu, count, lat_hist_percentile(h, count, 50),
+		lat_hist_percentile(h, count, 99), READ_ONCE(h->max_ns));
+	for(bucket = 0; bucket < LAT_HIST_BUCKETS; bucket++) {
+		seq_printf(m, " %lu", READ_ONCE(h->buckets[bucket]));
+	}
+	seq_putc(m, '\n');
+}
+
+/**
+	Function Name : print_process_queue_stats
+	Function Type : Queue Function
+	Description	  :	Method writes the scheduling statistics to a seq_file,
+					the switch statistics of every CPU followed by the
+					statistics of every process. The deadlines missed and
+					the level are those of the edf and mlfq policies. Lock
+					free, the run queues are walked under RCU, so the
+					counters of one line may be taken between two updates.
+					The waiting and running times exclude the current state.
+*/
+int print_process_queue_stats(struct seq_file *m) {
+
+	static const char states[] = "CRWBT";
+	/**Sums of the histograms, off the stack as the caller may be deep.*/
+	static struct lat_hist dispatch_all, stop_all;
+	static DEFINE_MUTEX(stats_mutex);
+	struct proc_cpu_rq *crq;
+	struct proc *tmp;
+	struct proc_group *group;
+	unsigned long nr_ticks, nr_enforced;
+	unsigned int bucket;
+	char name[8];
+	int cpu;
+
+	seq_printf(m, "enforce %s\n", task_enforce->name);
+	seq_puts(m, "cpu ticks switches tick_avg_ns tick_max_ns enforced enforce_avg_ns enforce_max_ns enforce_coalesced\n");
+	for_each_online_cpu(cpu) {
+		crq = per_cpu_ptr(&proc_rqs, cpu);
+		nr_ticks = READ_ONCE(crq->nr_ticks);
+		nr_enforced = READ_ONCE(crq->nr_enforced);
+		seq_printf(m, "%d %lu %lu %llu %llu %lu %llu %llu %lu\n", cpu, nr_ticks, READ_ONCE(crq->nr_switches),
+			nr_ticks ? div64_u64(READ_ONCE(crq->tick_sum_ns), nr_ticks) : 0, READ_ONCE(crq->tick_max_ns),
+			nr_enforced, nr_enforced ? div64_u64(READ_ONCE(crq->enforce_sum_ns), nr_enforced) : 0,
+			READ_ONCE(crq->enforce_max_ns), READ_ONCE(crq->nr_enforce_coalesced));
+	}
+	/**The latency histograms of every CPU, then summed over the CPUs.*/
+	seq_puts(m, "latency cpu count p50_ns p99_ns max_ns buckets\n");
+	mutex_lock(&stats_mutex);
+	memset(&dispatch_all, 0, sizeof(dispatch_all));
+	memset(&stop_all, 0, sizeof(stop_all));
+	for_each_online_cpu(cpu) {
+		crq = per_cpu_ptr(&proc_rqs, cpu);
+		snprintf(name, sizeof(name), "%d", cpu);
+		print_lat_hist(m, "dispatch", name, &crq->dispatch_lat);
+		print_lat_hist(m, "stop", name, &crq->stop_lat);
+		for(bucket = 0; bucket < LAT_HIST_BUCKETS; bucket++) {
+			dispatch_all.buckets[bucket] += READ_ONCE(crq->dispatch_lat.buckets[bucket]);
+			stop_all.buckets[bucket] += READ_ONCE(crq->stop_lat.buckets[bucket]);
+		}
+		dispatch_all.max_ns = max(dispatch_all.max_ns, READ_ONCE(crq->dispatch_lat.max_ns));
+		stop_all.max_ns = max(stop_all.max_ns, READ_ONCE(crq->stop_lat.max_ns));
+	}
+	/**Counting from the summed buckets keeps the percentiles consistent.*/
+	for(bucket = 0; bucket < LAT_HIST_BUCKETS; bucket++) {
+		dispatch_all.count += dispatch_all.buckets[bucket];
+		stop_all.count += stop_all.buckets[bucket];
+	}
+	print_lat_hist(m, "dispatch", "all", &dispatch_all);
+	print_lat_hist(m, "stop", "all", &stop_all);
+	mutex_unlock(&stats_mutex);
+	seq_puts(m, "pid tgid cpu group state dispatches preemptions run_ns wait_ns first_dispatch_ns missed_deadlines level\n");
+	/**Entering the RCU read side, writers are not blocked.*/
+	rcu_read_lock();
+	for_each_online_cpu(cpu) {
+		for_each_process_group(group) {
+			for_each_process_in_rq_rcu(tmp, per_cpu_ptr(group->rqs, cpu)) {
+				seq_printf(m, "%d %d %d %s %c %lu %lu %llu %llu %llu %lu %u\n",
+					tmp->pid, tmp->gang->tgid, cpu, group->name, states[READ_ONCE(tmp->state)],
+					READ_ONCE(tmp->stats.nr_dispatches), READ_ONCE(tmp->stats.nr_preemptions),
+					READ_ONCE(tmp->stats.run_ns), READ_ONCE(tmp->stats.wait_ns), READ_ONCE(tmp->stats.first_dispatch_ns),
+					READ_ONCE(tmp->se.nr_missed), READ_ONCE(tmp->se.level));
+			}
+		}
+	}
+	rcu_read_unlock();
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : get_first_process_in_queue
+	Function Type : Queue Function
+	Description	  :	Method is invoked for getting the first waiting process
+					in the queue, looking at the run queues in CPU order,
+					at their groups in creation order and at each group
+					in registration order. The running
+					processes stay in their queue, so they are skipped
+					here. Lock free, the run queues are walked under RCU.
+*/
+int get_first_process_in_queue(void) {
+
+	struct proc *tmp;
+	struct proc_group *group;
+	int cpu;
+	/**Initially set the process id value as an INVALID value.*/
+	int pid = INVALID_PID;
+	/**Entering the RCU read side, writers are not blocked.*/
+	rcu_read_lock();
+
+	for_each_online_cpu(cpu) {
+		for_each_process_group(group) {
+			/**
+				Iterate over the process queue and stop at the first active process.
+				Dead tasks are reaped on every tick, so the head is normally the
+				answer.
+			*/
+			for_each_process_in_rq_rcu(tmp, per_cpu_ptr(group->rqs, cpu)) {
+				/**Check if the process is waiting and its task is not terminated.*/
+				if(READ_ONCE(tmp->state) != eRunning && is_task_exists(tmp->pid_ref)==eTaskStatusExist) {
+					/**Set the process id to read process.*/
+					pid = tmp->pid;	
+					break;
+				}
+			}
+			if(pid != INVALID_PID) {
+				break;
+			}
+		}
+		if(pid != INVALID_PID) {
+			break;
+		}
+	}
+	rcu_read_unlock();
+
+	/**Returns the first process ID*/
+	return pid;
+}
+
+/**
+	Function Name : switch_process_in_queue
+	Function Type : Queue Function
+	Description	  :	Method performs one complete context switch on the run
+					queue of the given CPU within a single critical section.
+					It gives the process running on the CPU back to the
+					policy of its group and charges the group, reaps
+					terminated processes, dispatches the process picked by
+					the policy of the group of smallest vruntime and marks
+					it running. When the previous process is picked again
+					it keeps running and no signal is sent. The slice the
+					policy wants for the running process is stored in
+					slice_ns, 0 meaning the default quantum. An idle CPU
+					gets the shortest slice the policies of its groups ask
+					for without a running process. When nothing
+					waits otherwise it is SCHED_SLICE_TICKLESS, the tick stops and
+					the next enqueue asks the scheduler for a switch through
+					its resched callback. Returns the pid
+					of the running process or INVALID_PID if the run queue
+					holds no live process.
+*/
+int switch_process_in_queue(int cpu, u64 *slice_ns) {
+
+	struct proc_cpu_rq *crq = per_cpu_ptr(&proc_rqs, cpu);
+	struct proc_group *group;
+	struct proc_rq *rq;
+	struct proc *prev, *next;
+	unsigned long flags;
+	u64 now, tick_ns, idle_slice_ns;
+	bool blocked;
+	/**Initially set the process id value as an INVALID value.*/
+	int pid = INVALID_PID, prev_pid = INVALID_PID;
+	/**
+		Acquiring the run queue spinlock. The lock is usable from atomic
+		context and cannot be interrupted by a signal.
+	*/
+	spin_lock_irqsave(&crq->lock, flags);
+	now = ktime_get_ns();
+	/**The tick is running, the enqueues below need not restart it.*/
+	crq->tick_stopped = false;
+	/**Giving the previously running process back to the policy of its group.*/
+	prev = crq->curr;
+	if(prev != NULL) {
+		prev_pid = prev->pid;
+		account_process_state(prev, now);
+		rq = group_rq_of(prev);
+		/**Measuring the CPU time the process used during its slice.*/
+		account_process_burst(crq, prev);
+		/**A process asleep waits for its wakeup off the policy, the tick hook sees it blocked.*/
+		blocked = block_process(crq, prev);
+		if(rq->policy->tick != NULL) {
+			rq->policy->tick(rq, prev, prev->last_burst_ns);
+		}
+		charge_group(crq, rq, prev->last_burst_ns);
+		/**Any other process waits for its turn.*/
+		if(!blocked) {
+			prev->state = eWaiting;
+			enqueue_process(crq, prev);
+		}
+	}
+	/**Polling for dead processes before the policy picks, only needed while task exit is not hooked.*/
+	if(queue_probes[eProbeExit].tp == NULL) {
+		reap_terminated_processes(crq, &prev);
+	}
+	/**Clearing the running slot, filled again below with the picked process.*/
+	set_curr_process(crq, NULL);
+	/**A member of a gang another CPU got running joins it.*/
+	next = pull_gang_process(crq);
+	if(next != NULL && next != prev && change_task_of_process(next, eRunning) != eTaskStatusExist) {
+		reap_process_node(crq, next);
+		next = NULL;
+	}
+	/**Letting the groups and their policies pick among the waiting processes, skipping the dead ones.*/
+	while(next == NULL && (next = pick_next_process(crq)) != NULL) {
+		dequeue_process(crq, next);
+		/**Resume the picked process unless it never stopped.*/
+		if(next == prev || change_task_of_process(next, eRunning) == eTaskStatusExist) {
+			break;
+		}
+		/**The task is gone, another process is picked.*/
+		reap_process_node(crq, next);
+		next = NULL;
+	}
+	/**The state changes requested below are timed until the tasks get on and off the CPU, see probe_process_switch.*/
+	crq->cont_pid = next != NULL && next != prev ? next->pid : INVALID_PID;
+	crq->cont_ns = ktime_get_ns();
+	crq->stop_pid = INVALID_PID;
+	/**Pause the previous process unless it is the one picked again or asleep.*/
+	if(prev != NULL && prev != next && prev->state != eBlocked) {
+		crq->stop_ns = ktime_get_ns();
+		if(change_task_of_process(prev, eWaiting) == eTaskStatusTerminated) {
+			reap_process_node(crq, prev);
+		}
+		else {
+			crq->stop_pid = prev->pid;
+			prev->stats.nr_preemptions++;
+		}
+	}
+	else if(prev != NULL && prev != next) {
+		/**Only counting the sleeping process out of its gang.*/
+		change_task_of_process(prev, eBlocked);
+	}
+	if(next != NULL && next != prev) {
+		account_process_state(next, now);
+		if(next->stats.nr_dispatches++ == 0) {
+			next->stats.first_dispatch_ns = now - next->stats.registered_ns;
+		}
+		crq->nr_switches++;
+	}
+	if(next != NULL) {
+		next->state = eRunning;
+		set_curr_process(crq, next);
+		pid = next->pid;
+		/**Starting the measurement of the new slice.*/
+		if(next != prev) {
+			next->dispatch_cputime_ns = task_cputime_ns(next->pid_ref);
+		}
+		/**Groups waking up later start from the group running now.*/
+		crq->min_vruntime = max(crq->min_vruntime, group_rq_of(next)->vruntime);
+	}
+	/**Asking the policy of the running group for the slice of the running process.*/
+	*slice_ns = 0;
+	if(crq->curr != NULL) {
+		rq = group_rq_of(crq->curr);
+		if(rq->policy->timeslice != NULL) {
+			*slice_ns = rq->policy->timeslice(rq, crq->curr);
+		}
+	}
+	else {
+		/**Idle, the policy of every group may still need a switch, e.g. to release a throttled reservation.*/
+		rcu_read_lock();
+		for_each_process_group(group) {
+			rq = per_cpu_ptr(group->rqs, cpu);
+			if(rq->policy->timeslice != NULL) {
+				idle_slice_ns = rq->policy->timeslice(rq, NULL);
+				if(idle_slice_ns != 0 && (*slice_ns == 0 || idle_slice_ns < *slice_ns)) {
+					*slice_ns = idle_slice_ns;
+				}
+			}
+		}
+		rcu_read_unlock();
+	}
+	/**
+		Nothing waits, so the next switch could only give the CPU back to
+		the running process or leave it idle. The tick stops until a
+		process is enqueued, unless a reservation is to be enforced or an
+		idle policy asked for a switch.
+	*/
+	if(RB_EMPTY_ROOT(&crq->groups.rb_root) && (crq->curr == NULL ? *slice_ns == 0 : crq->curr->attr.runtime_ns == 0)) {
+		WRITE_ONCE(crq->tick_stopped, true);
+		*slice_ns = SCHED_SLICE_TICKLESS;
+	}
+	trace_process_sched_dispatch(cpu, prev_pid, pid, *slice_ns);
+	/**Accounting the time the switch took.*/
+	tick_ns = ktime_get_ns() - now;
+	crq->nr_ticks++;
+	crq->tick_sum_ns += tick_ns;
+	crq->tick_max_ns = max(crq->tick_max_ns, tick_ns);
+	/**Releasing the run queue spinlock.*/
+	spin_unlock_irqrestore(&crq->lock, flags);
+
+	/**Returns the running process ID*/
+	return pid;
+}
+
+/**
+	Function Name : steal_process_to_cpu
+	Function Type : Queue Function
+	Description	  :	Method is invoked by an idle CPU to take one waiting
+					process from the busiest run queue. The process is
+					moved to the sub-queue of its group on the given CPU,
+					enqueued in its policy and pinned to it. Must be called
+					from process context. Returns the pid of the stolen
+					process or INVALID_PID.
+*/
+int steal_process_to_cpu(int cpu) {
+
+	struct proc_cpu_rq *this_rq = per_cpu_ptr(&proc_rqs, cpu), *src = NULL, *rq;
+	struct proc_cpu_rq *first, *second;
+	struct proc_rq *src_grq;
+	struct proc *victim;
+	struct pid *pid_ref = NULL;
+	unsigned int waiting, max_waiting = 0;
+	unsigned long flags;
+	int i, pid = INVALID_PID;
+
+	/**The CPU of the parked tasks takes no process.*/
+	if(!is_sched_cpu(cpu)) {
+		return INVALID_PID;
+	}
+	/**Finding the run queue with the most waiting processes, without locking.*/
+	for_each_online_cpu(i) {
+		if(i == cpu || !is_sched_cpu(i)) {
+			continue;
+		}
+		rq = per_cpu_ptr(&proc_rqs, i);
+		waiting = READ_ONCE(rq->nr_procs) - (READ_ONCE(rq->curr) != NULL ? 1 : 0);
+		if(waiting > max_waiting) {
+			max_waiting = waiting;
+			src = rq;
+		}
+	}
+	if(src == NULL) {
+		/**Nothing to steal.*/
+		return INVALID_PID;
+	}
+
+	/**Locking both run queues in CPU order to avoid an ABBA deadlock.*/
+	first = src->cpu < cpu ? src : this_rq;
+	second = src->cpu < cpu ? this_rq : src;
+	spin_lock_irqsave(&first->lock, flags);
+	spin_lock_nested(&second->lock, SINGLE_DEPTH_NESTING);
+
+	/**Taking the process the busy CPU would run next, unless pinned there or kept by the policy of its group.*/
+	victim = pick_next_process(src);
+	if(victim != NULL) {
+		src_grq = group_rq_of(victim);
+		if(victim->attr.pinned || (src_grq->policy->can_migrate != NULL && !src_grq->policy->can_migrate(src_grq, victim))) {
+			victim = NULL;
+		}
+	}
+	if(victim != NULL) {
+		dequeue_process(src, victim);
+		detach_process_node(src, victim);
+		victim->cpu = cpu;
+		attach_process_node(this_rq, victim);
+		enqueue_process(this_rq, victim);
+		pid = victim->pid;
+		/**Keeping the pid alive for the pinning below.*/
+		pid_ref = get_pid(victim->pid_ref);
+	}
+
+	spin_unlock(&second->lock);
+	spin_unlock_irqrestore(&first->lock, flags);
+
+	if(pid_ref != NULL) {
+		pr_debug("CPU %d stole Process %d from CPU %d\n", cpu, pid, src->cpu);
+		/**
+			Applying the stop still queued on the old CPU before the new
+			one runs the task, then pinning it there. A parked task stays
+			parked until its new CPU runs it.
+		*/
+		flush_task_enforce(src);
+		if(!task_enforce->parks) {
+			task_affinity_change(pid_ref, cpumask_of(cpu));
+		}
+		put_pid(pid_ref);
+	}
+	return pid;
+}
+
+/**
+	Function Name : get_run_queue_load
+	Function Type : Queue Function
+	Description	  :	Method reports the number of processes in the run queue
+					of the given CPU, all groups included, and the average
+					CPU time they used in their last slice. Lock free, both
+					values are maintained incrementally and read as a
+					snapshot.
+*/
+int get_run_queue_load(int cpu, unsigned int *nr_procs, u64 *avg_burst_ns) {
+
+	struct proc_cpu_rq *rq = per_cpu_ptr(&proc_rqs, cpu);
+	unsigned int nr = READ_ONCE(rq->nr_procs);
+
+	*nr_procs = nr;
+	*avg_burst_ns = nr ? div64_u64(READ_ONCE(rq->burst_sum_ns), nr) : 0;
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : set_process_queue_resched
+	Function Type : Queue Function
+	Description	  :	Method installs the callback the queue uses to make a
+					CPU switch before its slice ends, e.g. when its running
+					process exits, or restart its stopped tick. NULL removes
+					it and waits until no caller can still be running the
+					old one.
+*/
+void set_process_queue_resched(void (*resched)(int cpu, bool now)) {
+
+	rcu_assign_pointer(resched_cpu_fn, resched);
+	if(resched == NULL) {
+		synchronize_rcu();
+	}
+}
+
+/**
+	Function Name : resched_process_queue_cpu
+	Function Type : Queue Helper
+	Description	  :	Method asks the scheduler to switch the given CPU at
+					once, or with now false to restart its stopped tick,
+					the running process finishing its quantum. Does nothing
+					if no scheduler is loaded. Usable from atomic context.
+*/
+static void resched_process_queue_cpu(int cpu, bool now) {
+
+	void (*resched)(int cpu, bool now);
+
+	rcu_read_lock();
+	resched = rcu_dereference(resched_cpu_fn);
+	if(resched != NULL) {
+		resched(cpu, now);
+	}
+	rcu_read_unlock();
+}
+
+/**
+	Function Name : check_preempt_process
+	Function Type : Queue Helper
+	Description	  :	Method asks for a switch at once when the given process,
+					just enqueued, should run now: the CPU runs nothing, or
+					the policy of its sub-queue ranks it above the running
+					process of the same sub-queue. Processes of other groups
+					wait for the switch, the groups share the CPU by time.
+					Caller must hold the run queue spinlock.
+*/
+static void check_preempt_process(struct proc_cpu_rq *crq, struct proc *node) {
+
+	struct proc_rq *rq = group_rq_of(node);
+
+	if(crq->curr == NULL) {
+		resched_process_queue_cpu(crq->cpu, true);
+	}
+	else if(crq->curr->group == node->group && rq->policy->check_preempt != NULL && rq->policy->check_preempt(rq, crq->curr, node)) {
+		trace_process_sched_preempt(crq->cpu, crq->curr->pid, node->pid);
+		resched_process_queue_cpu(crq->cpu, true);
+	}
+}
+
+/**
+	Function Name : kick_idle_process_queue
+	Function Type : Queue Helper
+	Description	  :	Method restarts the tick of one idle CPU whose tick is
+					stopped, other than the given busy one. Its switch
+					finds nothing to run and steals the waiting process.
+					Idle CPUs do not tick, so they would not look for work
+					by themselves. Linear in the number of CPUs, lockless.
+*/
+static void kick_idle_process_queue(int busy_cpu) {
+
+	struct proc_cpu_rq *rq;
+	int cpu;
+
+	for_each_online_cpu(cpu) {
+		rq = per_cpu_ptr(&proc_rqs, cpu);
+		if(cpu != busy_cpu && is_sched_cpu(cpu) && READ_ONCE(rq->tick_stopped) && READ_ONCE(rq->curr) == NULL) {
+			resched_process_queue_cpu(cpu, true);
+			return;
+		}
+	}
+}
+
+/**
+	Function Name : probe_process_exit
+	Function Type : Tracepoint Probe
+	Description	  :	Probe of the sched_process_exit tracepoint, run by every
+					exiting task. A registered process is removed from the
+					queue at once, an O(1) lookup in the pid hash index for
+					the others. If it was running, its CPU switches without
+					waiting for the end of the slice. Atomic context.
+*/
+static void probe_process_exit(void *data, struct task_struct *p) {
+
+	struct proc *node;
+	struct proc_cpu_rq *rq;
+	unsigned long flags;
+	bool was_running;
+
+	node = lock_process_in_queue(p->pid, &rq, &flags);
+	if(node == NULL) {
+		/**Not one of ours.*/
+		return;
+	}
+	/**The index is keyed by the pid seen at registration, checking it is the same task.*/
+	if(node->pid_ref != task_pid(p)) {
+		spin_unlock_irqrestore(&rq->lock, flags);
+		return;
+	}
+	was_running = rq->curr == node;
+	reap_process_node(rq, node);
+	/**Releasing the run queue spinlock.*/
+	spin_unlock_irqrestore(&rq->lock, flags);
+
+	if(was_running) {
+		resched_process_queue_cpu(rq->cpu, true);
+	}
+}
+
+/**
+	Function Name : yield_process_in_queue
+	Function Type : Queue Function
+	Description	  :	Method makes the given process give its CPU up before
+					its slice ends, if it is running. It goes back to its
+					policy as a waiting process. Returns -ESRCH if the pid
+					is not registered.
+*/
+int yield_process_in_queue(int pid) {
+
+	struct proc *node;
+	struct proc_cpu_rq *rq;
+	unsigned long flags;
+	bool running;
+
+	node = lock_process_in_queue(pid, &rq, &flags);
+	if(node == NULL) {
+		return -ESRCH;
+	}
+	running = rq->curr == node;
+	/**Releasing the run queue spinlock.*/
+	spin_unlock_irqrestore(&rq->lock, flags);
+
+	if(running) {
+		resched_process_queue_cpu(rq->cpu, true);
+	}
+	/**Function executed successfully.*/
+	return 0;
+}
+
+/**
+	Function Name : block_process
+	Function Type : Queue Helper
+	Description	  :	Method parks the process getting off the CPU in the
+					blocked state if its task is asleep. It is neither
+					stopped nor enqueued, the wakeup probe brings it back.
+					Returns false, with nothing changed, if the task is
+					runnable or wakeups are not hooked. Caller must hold
+					the run queue spinlock.
+*/
+static bool block_process(struct proc_cpu_rq *crq, struct proc *node) {
+
+	if(queue_probes[eProbeWakeup].tp == NULL || !is_task_blocked(node->pid_ref)) {
+		return false;
+	}
+	node->state = eBlocked;
+	list_add_tail(&node->block_list, &crq->blocked);
+	/**
+		Pairs with the barrier of the wakeup probe. Either the probe sees
+		the blocked state or the task is seen runnable again here.
+	*/
+	smp_mb();
+	if(!is_task_blocked(node->pid_ref)) {
+		list_del_init(&node->block_list);
+		return false;
+	}
+	return true;
+}
+
+/**
+	Function Name : wake_blocked_processes
+	Function Type : Interrupt Work
+	Description	  :	Work queued by the wakeup probe on the CPU of a blocked
+					process. Every blocked process of the run queue whose
+					task is runnable again becomes a waiting process, it is
+					stopped and handed to its policy. An idle CPU switches
+					at once, a busy one if the policy lets a woken process
+					preempt. Linear in the number of blocked processes of
+					the CPU.
+*/
+static void wake_blocked_processes(struct irq_work *work) {
+
+	struct proc_cpu_rq *crq = container_of(work, struct proc_cpu_rq, wake_work);
+	struct proc *node, *tmp;
+	unsigned long flags;
+	bool woken = false, idle;
+
+	spin_lock_irqsave(&crq->lock, flags);
+	list_for_each_entry_safe(node, tmp, &crq->blocked, block_list) {
+		if(is_task_blocked(node->pid_ref)) {
+			continue;
+		}
+		list_del_init(&node->block_list);
+		/**Stopping the woken task until its policy picks it.*/
+		if(change_task_of_process(node, eWaiting) == eTaskStatusTerminated) {
+			reap_process_node(crq, node);
+			continue;
+		}
+		account_process_state(node, ktime_get_ns());
+		node->state = eWaiting;
+		enqueue_process(crq, node);
+		check_preempt_process(crq, node);
+		woken = true;
+	}
+	idle = crq->curr == NULL;
+	/**Releasing the run queue spinlock.*/
+	spin_unlock_irqrestore(&crq->lock, flags);
+
+	/**The woken processes wait behind a running one, a CPU with a stopped tick may take them.*/
+	if(woken && !idle) {
+		kick_idle_process_queue(crq->cpu);
+	}
+}
+
+/**
+	Function Name : probe_process_switch
+	Function Type : Tracepoint Probe
+	Description	  :	Probe of the sched_switch tracepoint. It measures how
+					long the processes continued and stopped by the last
+					switch of the CPU take to get on and off it. When the
+					process running on its CPU goes to sleep, the CPU is
+					asked to switch at once instead of idling out the slice. Runs
+					under the kernel run queue lock, so the queue lock is
+					not taken here, the switch parks the process. O(1).
+*/
+static void probe_process_switch(void *data, bool preempt, struct task_struct *prev, struct task_struct *next) {
+
+	struct proc_cpu_rq *crq = this_cpu_ptr(&proc_rqs);
+	struct proc *node;
+	int cpu = -1;
+
 	/**
-		Iterating over the list of nodes pertaining to the process information
-		and removing one by one.
+		Timing the signals of the last switch of this CPU, whose processes
+		are pinned here. Runs with interrupts disabled, as the switch.
 	*/
-	list_for_each_entry_safe(node, tmp, &(top.list), list) {
-	
-		/**Deleting link pointer established by the node to the list.*/
-		list_del(&node->list);
-		/**Removing the whole node.*/
-		kfree(node);
+	if(crq->stop_pid == prev->pid && (READ_ONCE(prev->state) & __TASK_STOPPED)) {
+		lat_hist_add(&crq->stop_lat, ktime_get_ns() - crq->stop_ns);
+		crq->stop_pid = INVALID_PID;
+	}
+	if(crq->cont_pid == next->pid) {
+		lat_hist_add(&crq->dispatch_lat, ktime_get_ns() - crq->cont_ns);
+		crq->cont_pid = INVALID_PID;
+	}
+
+	/**Preempted or yielding tasks stay runnable, only sleeps matter.*/
+	if(preempt || (READ_ONCE(prev->state) & (TASK_INTERRUPTIBLE | TASK_UNINTERRUPTIBLE)) == 0) {
+		return;
+	}
+	rcu_read_lock();
+	node = find_process_in_queue(prev->pid);
+	if(node != NULL && node->pid_ref == task_pid(prev)) {
+		cpu = READ_ONCE(node->cpu);
+		if(READ_ONCE(per_cpu_ptr(&proc_rqs, cpu)->curr) != node) {
+			cpu = -1;
+		}
+	}
+	rcu_read_unlock();
+
+	if(cpu >= 0) {
+		resched_process_queue_cpu(cpu, true);
 	}
-	/**Function returns success.*/
-	return 0;
 }
 
 /**
-	Function Name : add_process_to_queue
-	Function Type : Queue Function
-	Description	  :	Method is invoked for adding a process into a queue.
+	Function Name : probe_process_wakeup
+	Function Type : Tracepoint Probe
+	Description	  :	Probe of the sched_wakeup tracepoint. A blocked process
+					that wakes up is brought back by the interrupt work of
+					its CPU, the queue lock is not taken under the kernel
+					run queue lock. O(1).
 */
-int add_process_to_queue(int pid) {
-			
-	/**Allocating space for the newly registered process.*/
-	struct proc *new_process = kmalloc(sizeof(struct proc), GFP_KERNEL);
-	
-	/**Check if the kmalloc call was successful or not.*/	
-	if(!new_process) {
+static void probe_process_wakeup(void *data, struct task_struct *p) {
 
-		printk(KERN_ALERT "Process Queue ERROR:kmalloc function failed from add_process_to_queue function.");
-		/** Add process to queue error.*/
-		return -ENOMEM;
-	}
-	/**Setting the process id to the process info node new_process*/
-	new_process->pid = pid;
-	/**Setting the process state to the process info node new_process as waiting.*/
-	new_process->state = eWaiting;
-	/**Make the task level alteration therefore the process pauses its execution since in wait state.*/
-	task_status_change(new_process->pid, new_process-> state);//TODO:Error handling to be added.
-
-	/** 
-		Condition to verify the down operation on the binary semaphore
-		mutex. Entry into a Mutually exclusive block is granted by
-		having a successful lock with the mentioned semaphore.
-		mutex semaphore provides a safe access to the following
-		critical section.
-	*/
-	if(down_interruptible(&mutex)){
-		printk(KERN_ALERT "Process Queue ERROR:Mutual Exclusive position access failed from add function");
-		/** Issue a restart of syscall which was supposed to be executed.*/
-		return -ERESTARTSYS;
-	}
+	struct proc *node;
+	int cpu = -1;
 
-	/**Initialize the new process list as the new head.*/
-	INIT_LIST_HEAD(&new_process->list);
-	/**Set the new process as a tail to the previous top of the list.*/
-	list_add_tail(&(new_process->list), &(top.list));
-	
-	/** 
-		Performing an up operation on mutex. Such an operation
-		indicates the critical section is released for other
-		processes/threads.
-	*/
-	up(&mutex);
+	rcu_read_lock();
+	node = find_process_in_queue(p->pid);
+	if(node != NULL && node->pid_ref == task_pid(p)) {
+		/**Pairs with the barrier of block_process.*/
+		smp_mb();
+		if(READ_ONCE(node->state) == eBlocked) {
+			cpu = READ_ONCE(node->cpu);
+		}
+	}
+	rcu_read_unlock();
 
-	printk(KERN_INFO "Adding the given Process %d to the  Process Queue...\n", pid);
-	/**Function executed successfully.*/
-	return 0;
+	if(cpu >= 0) {
+		if(cpu == get_cpu()) {
+			irq_work_queue(&per_cpu_ptr(&proc_rqs, cpu)->wake_work);
+		}
+		else {
+			irq_work_queue_on(&per_cpu_ptr(&proc_rqs, cpu)->wake_work, cpu);
+		}
+		put_cpu();
+	}
 }
 
 /**
-	Function Name : remove_process_from_queue
-	Function Type : Queue Function
-	Description	  :	Method is invoked for removing a given process 
-					from the queue.
+	Function Name : probe_process_fork
+	Function Type : Tracepoint Probe
+	Description	  :	Probe of the sched_process_fork tracepoint. With
+					follow_fork set, a child or thread of a registered
+					process is queued for registration with the attributes
+					of its parent. Probes cannot sleep, a work item
+					registers it. A new process is stopped before it first
+					runs so it does not escape the scheduler meanwhile, a
+					thread is not as it would stop its whole process.
 */
-int remove_process_from_queue(int pid) {
-		 	
-	struct proc *tmp, *node;
-	/** 
-		Condition to verify the down operation on the binary semaphore
-		mutex. Entry into a Mutually exclusive block is granted by
-		having a successful lock with the mentioned semaphore.
-		mutex semaphore provides a safe access to the following
-		critical section.
-	*/
-	if(down_interruptible(&mutex)){
-		printk(KERN_ALERT "Process Queue ERROR:Mutual Exclusive position access failed from remove function");
-		/** Issue a restart of syscall which was supposed to be executed.*/
-		return -ERESTARTSYS;
+static void probe_process_fork(void *data, struct task_struct *parent, struct task_struct *child) {
+
+	struct proc *node;
+	struct forked_proc *fp = NULL;
+
+	if(!READ_ONCE(follow_fork)) {
+		return;
 	}
-	/**Iterating over the process queue and removing the process with provided pid.*/	
-	list_for_each_entry_safe(node, tmp, &(top.list), list) {
-	
-		/**Check if the node pid is the same as the required pid.*/
-		if(node->pid == pid) {
-			printk(KERN_INFO "Removing the given Process %d from the  Process Queue...\n", pid);
-			/**Deleting link pointer established by the node to the list.*/
-			list_del(&node->list);
-			/**Removing the whole node.*/
-			kfree(node);
+	rcu_read_lock();
+	node = find_process_in_queue(parent->pid);
+	if(node != NULL && node->pid_ref == task_pid(parent)) {
+		fp = kmalloc(sizeof(*fp), GFP_ATOMIC);
+		if(fp != NULL) {
+			fp->attr = node->attr;
 		}
 	}
-	/** 
-		Performing an up operation on mutex. Such an operation
-		indicates the critical section is released for other
-		processes/threads.
-	*/
-	up(&mutex);
-	/**Function executed successfully.*/
-	return 0;
+	rcu_read_unlock();
+
+	if(node != NULL && fp == NULL) {
+		printk(KERN_ALERT "Process Queue ERROR:child %d of a registered process cannot be followed.\n", child->pid);
+		return;
+	}
+	if(fp == NULL) {
+		return;
+	}
+	fp->pid_ref = get_pid(task_pid(child));
+	fp->stopped = thread_group_leader(child);
+	/**Held with a signal whatever the backend, the child has no CPU yet.*/
+	if(fp->stopped) {
+		kill_pid(fp->pid_ref, SIGSTOP, 1);
+	}
+	llist_add(&fp->node, &forked_procs);
+	schedule_work(&fork_work);
 }
 
 /**
-	Function Name : remove_terminated_processes_from_queue
-	Function Type : Queue Job
-	Description	  :	Method is invoked for removing all terminated processes
-					from the queue.
+	Function Name : register_forked_processes
+	Function Type : Work Function
+	Description	  :	Work registering the children queued by the fork probe.
 */
-int remove_terminated_processes_from_queue(void) {
-		 	
-	struct proc *tmp, *node;
-	/** 
-		Condition to verify the down operation on the binary semaphore
-		mutex. Entry into a Mutually exclusive block is granted by
-		having a successful lock with the mentioned semaphore.
-		mutex semaphore provides a safe access to the following
-		critical section.
-	*/
-	if(down_interruptible(&mutex)){
-		printk(KERN_ALERT "Process Queue ERROR:Mutual Exclusive position access failed from remove function");
-		/** Issue a restart of syscall which was supposed to be executed.*/
-		return -ERESTARTSYS;
-	}	
-	/**Iterate over the process queue and remove all terminated processes from the queue.*/
-	list_for_each_entry_safe(node, tmp, &(top.list), list) {
-	
-		/**Check if the process is terminated or not.*/
-		if(node->state == eTerminated) {
-			printk(KERN_INFO "Removing the terminated Process %d from the  Process Queue...\n", node->pid);
-			/**Deleting link pointer established by the node to the list.*/
-			list_del(&node->list);
-			/**Removing the whole node.*/
-			kfree(node);
-		}
-	}
-	/** 
-		Performing an up operation on mutex. Such an operation
-		indicates the critical section is released for other
-		processes/threads.
-	*/
-	up(&mutex);
-	/**Function executed successfully.*/
-	return 0;
+static void register_forked_processes(struct work_struct *work) {
+
+	drain_forked_processes(true);
 }
 
 /**
-	Function Name : change_process_state_in_queue
-	Function Type : Queue Function
-	Description	  :	Method is invoked for changing the process state 
-					for a given process in the queue.
+	Function Name : drain_forked_processes
+	Function Type : Queue Helper
+	Description	  :	Method empties the children queued by the fork probe,
+					in fork order, registering them if asked to. A child
+					keeps the group and tickets of its parent. A reservation
+					the CPUs cannot admit is dropped, the child runs best
+					effort rather than outside the scheduler. A child that
+					is not registered, e.g. it already exited, is continued,
+					as is a registered one once a backend other than the
+					signals holds it.
+					Must be called from process context.
 */
-int change_process_state_in_queue(int pid, int changeState) {
-		 	
-	struct proc *tmp, *node;
+static void drain_forked_processes(bool do_register) {
 
-	/**Enumeration to expect the task_status change function call.*/
-	enum process_state ret_process_change_status;
-
-	/** 
-		Condition to verify the down operation on the binary semaphore
-		mutex. Entry into a Mutually exclusive block is granted by
-		having a successful lock with the mentioned semaphore.
-		mutex semaphore provides a safe access to the following
-		critical section.
-	*/
-	if(down_interruptible(&mutex)){
-		printk(KERN_ALERT "Process Queue ERROR:Mutual Exclusive position access failed from change process state function");
-		/** Issue a restart of syscall which was supposed to be executed.*/
-		return -ERESTARTSYS;
-	}	
-	/**Check if all registered PIDs are modified for state*/
-	if(pid == ALL_REG_PIDS) {
-		/**Iterate over all the processes in the queue and set the status the provided status.*/
-		list_for_each_entry_safe(node, tmp, &(top.list), list) {
-	
-			printk(KERN_INFO "Updating the process state the Process %d in  Process Queue...\n", node->pid);
-			/**Update the state to the provided state.*/
-			node->state = changeState;
-			/**Check if the task associated with the iterated node still exists or not.*/
-			if(task_status_change(node->pid, node->state)==eTaskStatusTerminated) {
-				/**Change state to terminated. Later handled by calling removeallterminated processes method*/	
-				node->state = eTerminated;
+	struct llist_node *list = llist_reverse_order(llist_del_all(&forked_procs));
+	struct forked_proc *fp, *tmp;
+	int ret;
+
+	llist_for_each_entry_safe(fp, tmp, list, node) {
+		ret = -ESRCH;
+		if(do_register && is_task_exists(fp->pid_ref) == eTaskStatusExist) {
+			ret = add_process_to_queue_attr(pid_nr(fp->pid_ref), &fp->attr);
+			if(ret == -EBUSY) {
+				fp->attr.runtime_ns = fp->attr.period_ns = fp->attr.deadline_ns = 0;
+				ret = add_process_to_queue_attr(pid_nr(fp->pid_ref), &fp->attr);
 			}
 		}
-	}
-	else {
-		/**Iterate over the queue and update the provided process with the state change.*/
-		list_for_each_entry_safe(node, tmp, &(top.list), list) {
-		
-			/**Check if the iterated node is the required process or not.*/
-			if(node->pid == pid) {
-				
-				printk(KERN_INFO "Updating the process state the Process %d in  Process Queue...\n", pid);
-				/**Update the state to the provided state.*/
-				node->state = changeState;
-				/**Check if the task associated with the iterated node still exists or not.*/
-				if(task_status_change(node->pid, node->state)==eTaskStatusTerminated) {
-					/**Change state to terminated. Later handled by calling removeallterminated processes method*/	
-					node->state = eTerminated;
-					/**Return value updated to notify that the requested process is already terminated.*/
-					ret_process_change_status = eTerminated;
-				}
-				//TODO:Else condition to be added.				
-			}
-			else {
-				/**Check if the task associated with the iterated node exists or not.*/
-				if(is_task_exists(node->pid)==eTaskStatusTerminated) {
-					/**Change state to terminated. Later handled by calling removeallterminated processes method*/
-					node->state = eTerminated;
-				}
-			}
+		/**Releasing the hold of the probe, unless the signal backend took the child over.*/
+		if(fp->stopped && (ret != 0 || task_enforce->run != signal_enforce_run)) {
+			kill_pid(fp->pid_ref, SIGCONT, 1);
 		}
+		put_pid(fp->pid_ref);
+		kfree(fp);
 	}
-	/** 
-		Performing an up operation on mutex. Such an operation
-		indicates the critical section is released for other
-		processes/threads.
-	*/
-	up(&mutex);
-
-	/**Return the process status change associated with the internal call to task status change method.*/
-	return ret_process_change_status;
 }
 
-
 /**
-	Function Name : print_process_queue
-	Function Type : Queue Function
-	Description	  :	Method is invoked for printing the process queue.
+	Function Name : find_queue_tracepoints
+	Function Type : Tracepoint Lookup
+	Description	  :	Callback of for_each_kernel_tracepoint keeping the
+					scheduler tracepoints the queue hooks, which are not
+					exported to modules by name.
 */
-int print_process_queue(void) {
-			
-	struct proc *tmp;
-	printk(KERN_INFO "Process Queue: \n");
-	/** 
-		Condition to verify the down operation on the binary semaphore
-		mutex. Entry into a Mutually exclusive block is granted by
-		having a successful lock with the mentioned semaphore.
-		mutex semaphore provides a safe access to the following
-		critical section.
-	*/
-	if(down_interruptible(&mutex)){
-		printk(KERN_ALERT "Process Queue ERROR:Mutual Exclusive position access failed from print function");
-		/** Issue a restart of syscall which was supposed to be executed.*/
-		return -ERESTARTSYS;
-	}	
-	/**Iterate over the queue and print each process id.*/
-	list_for_each_entry(tmp, &(top.list), list) {
-	
-		printk(KERN_INFO "Process ID: %d\n", tmp->pid);
+static void find_queue_tracepoints(struct tracepoint *tp, void *priv) {
+
+	int i;
+
+	for(i = 0; i < eProbeCount; i++) {
+		if(strcmp(tp->name, queue_probes[i].name) == 0) {
+			queue_probes[i].tp = tp;
+		}
 	}
-	/** 
-		Performing an up operation on mutex. Such an operation
-		indicates the critical section is released for other
-		processes/threads.
-	*/
-	up(&mutex);
-	/**Function executed successfully.*/
-	return 0;
 }
 
 /**
-	Function Name : get_first_process_in_queue
-	Function Type : Queue Function
-	Description	  :	Method is invoked for getting the first process in the queue.
+	Function Name : find_get_global_pid
+	Function Type : Task level Lookup
+	Description   : Method returns a counted reference to the pid of the
+					given number in the initial pid namespace, NULL if
+					none. The queue is keyed by these numbers, the ones
+					the tracepoints see as task->pid, whatever the
+					namespace of the registering process.
 */
-int get_first_process_in_queue(void) {
+static struct pid *find_get_global_pid(int pid) {
 
-	struct proc *tmp;
-	/**Initially set the process id value as an INVALID value.*/
-	int pid = INVALID_PID;
-	/** 
-		Condition to verify the down operation on the binary semaphore
-		mutex. Entry into a Mutually exclusive block is granted by
-		having a successful lock with the mentioned semaphore.
-		mutex semaphore provides a safe access to the following
-		critical section.
-	*/
-	if(down_interruptible(&mutex)){
-		printk(KERN_ALERT "Process Queue ERROR:Mutual Exclusive position access failed from print function");
-		/** Issue a restart of syscall which was supposed to be executed.*/
-		return -ERESTARTSYS;
-	}	
-
-	/**Iterate over the process queue and find the first active process.*/
-	list_for_each_entry(tmp, &(top.list), list) {
-		/**Check if the task associated with the process is terminated or not.*/
-		if((pid==INVALID_PID)&&(is_task_exists(tmp->pid)==eTaskStatusExist)) {
-			/**Set the process id to read process.*/
-			pid = tmp->pid;	
-		}
-		/*else if(is_task_exists(tmp->pid)==eTaskStatusTerminated) {
-			tmp->state = eTerminated;
-		}*/
-	}
-	/** 
-		Performing an up operation on mutex. Such an operation
-		indicates the critical section is released for other
-		processes/threads.
-	*/
-	up(&mutex);
+	struct pid *pid_ref;
 
-	/**Returns the first process ID*/
-	return pid;
+	rcu_read_lock();
+	pid_ref = get_pid(find_pid_ns(pid, &init_pid_ns));
+	rcu_read_unlock();
+	return pid_ref;
 }
 
 /**
 	Function Name : is_task_exists
 	Function Type : Task level Existence
-	Description   : Method checks if the task exists.
+	Description   : Method checks if the task exists. The pid reference
+					cached in the queue node is used directly, no pid hash
+					lookup is done. A task already exiting counts as
+					terminated, it may have passed the exit probe.
 */
-enum task_status_code is_task_exists(int pid) {
+enum task_status_code is_task_exists(struct pid *pid_ref) {
 	
 	/**Task structure construct.*/
 	struct task_struct *current_pr;	
-	/**Obtain the task struct associated with provided PID.*/
-	current_pr = pid_task(find_vpid(pid), PIDTYPE_PID);
+	bool exiting = false;
+	/**Obtain the task struct associated with provided pid reference.*/
+	rcu_read_lock();
+	current_pr = pid_task(pid_ref, PIDTYPE_PID);
+	if(current_pr != NULL) {
+		exiting = (READ_ONCE(current_pr->flags) & PF_EXITING) != 0;
+	}
+	rcu_read_unlock();
 	/**Check if the task exists or not by checking for NULL Value.*/
-	if(current_pr == NULL) {
+	if(current_pr == NULL || exiting) {
 		/**Return the task status code as terminated.*/
 		return eTaskStatusTerminated;
 	}
@@ -430,47 +3320,324 @@ enum task_status_code is_task_exists(int pid) {
 /**
 	Function Name : task_status_change
 	Function Type : Task level State change.
-	Description   : Method changes the status of the task.
+	Description   : Method changes the status of the task, through the
+					enforcement backend when it runs or waits. Called with
+					interrupts disabled, by the only context accounting
+					changes to cpu at a time. A backend that sleeps gets
+					the change queued for the enforcement work of cpu, as
+					the pending change of the process or gang pend.
 */
-enum task_status_code task_status_change(int pid, enum process_state eState) {
+enum task_status_code task_status_change(struct pid *pid_ref, int cpu, struct enforce_pending *pend, enum process_state eState) {
 
 	/**Task structure construct.*/
 	struct task_struct *current_pr;
-	/**Obtain the task struct associated with provided PID.*/
-	current_pr = pid_task(find_vpid(pid), PIDTYPE_PID);
+	struct proc_cpu_rq *crq = per_cpu_ptr(&proc_rqs, cpu);
+	/**Obtain the task struct associated with provided pid reference.*/
+	rcu_read_lock();
+	current_pr = pid_task(pid_ref, PIDTYPE_PID);
+	rcu_read_unlock();
 	/**Check if the task exists or not by checking for NULL Value.*/
 	if(current_pr == NULL) {
 		/**Return the task status code as terminated.*/
 		return eTaskStatusTerminated;
 	}
-	/**Check if the state change was Running.*/
-	if(eState == eRunning) {
+	/**Check if the state change was Running or Waiting.*/
+	if(eState == eRunning || eState == eWaiting) {
 
-		/**Trigger a signal to continue the given task associated with the process.*/
-		kill_pid(task_pid(current_pr), SIGCONT, 1);
-		printk(KERN_INFO "Task status change to Running\n");
-	}
-	/**Check if the state change was Waiting.*/
-	else if(eState == eWaiting) {
-		/**Trigger a signal to pause the given task associated with the process.*/
-		kill_pid(task_pid(current_pr), SIGSTOP, 1);
-		printk(KERN_INFO "Task status change to Waiting\n");
+		/**Continue or pause the given task associated with the process.*/
+		if(task_enforce->sleeps) {
+			queue_task_enforce(crq, pend, pid_ref, eState);
+		}
+		else {
+			apply_task_enforce(crq, pid_ref, cpu, eState);
+		}
+		pr_debug("Task status change to %s\n", eState == eRunning ? "Running" : "Waiting");
 	}
 	/**Check if the state change was Blocked.*/
 	else if(eState == eBlocked) {
 
-		printk(KERN_INFO "Task status change to Blocked\n");
+		pr_debug("Task status change to Blocked\n");
 	}
 	/**Check if the state change was Terminated.*/
 	else if(eState == eTerminated) {
 
-		printk(KERN_INFO "Task status change to Terminated\n");
+		pr_debug("Task status change to Terminated\n");
+	}
+	/**Return the task status code as exists.*/
+	return eTaskStatusExist;
+}
+
+/**
+	Function Name : signal_enforce_run
+	Function Type : Enforcement Backend
+	Description   : Method continues the task with SIGCONT. Atomic, but
+					seen by the parent in waitpid and by job control.
+*/
+static int signal_enforce_run(struct pid *pid_ref, int cpu) {
+
+	return kill_pid(pid_ref, SIGCONT, 1);
+}
+
+/**
+	Function Name : signal_enforce_stop
+	Function Type : Enforcement Backend
+	Description   : Method stops the task with SIGSTOP.
+*/
+static int signal_enforce_stop(struct pid *pid_ref, int cpu) {
+
+	return kill_pid(pid_ref, SIGSTOP, 1);
+}
+
+/**
+	Function Name : freezer_enforce_open
+	Function Type : Enforcement Helper
+	Description   : Method opens the given interface file of the cgroup v2
+					cgroup of the task, under cgroup_mount, and reports the
+					thread group of the task in tgid unless NULL. The root
+					cgroup is refused with -EINVAL, it cannot be frozen and
+					holds every other process. May sleep.
+*/
+static struct file *freezer_enforce_open(struct pid *pid_ref, const char *name, int flags, pid_t *tgid) {
+
+	struct task_struct *task;
+	struct file *filp;
+	char *path;
+	ssize_t len, end;
+	int ret;
+
+	path = kmalloc(PATH_MAX, GFP_KERNEL);
+	if(path == NULL) {
+		return ERR_PTR(-ENOMEM);
+	}
+	task = get_pid_task(pid_ref, PIDTYPE_PID);
+	if(task == NULL) {
+		kfree(path);
+		return ERR_PTR(-ESRCH);
+	}
+	len = strscpy(path, cgroup_mount, PATH_MAX);
+	ret = len != -E2BIG ? task_cgroup_path(task, path + len, PATH_MAX - len) : -ENAMETOOLONG;
+	if(tgid != NULL) {
+		*tgid = task_tgid_nr(task);
+	}
+	put_task_struct(task);
+	if(ret >= 0 && strcmp(path + len, "/") == 0) {
+		ret = -EINVAL;
+	}
+	/**Appending the file name, a truncated path is refused.*/
+	if(ret >= 0) {
+		end = strlen(path);
+		if(strscpy(path + end, "/", PATH_MAX - end) == -E2BIG || strscpy(path + end + 1, name, PATH_MAX - end - 1) == -E2BIG) {
+			ret = -ENAMETOOLONG;
+		}
+	}
+	filp = ret >= 0 ? filp_open(path, flags, 0) : ERR_PTR(ret);
+	kfree(path);
+	return filp;
+}
+
+/**
+	Function Name : freezer_enforce_write
+	Function Type : Enforcement Helper
+	Description   : Method writes the given value to cgroup.freeze of the
+					cgroup of the task. May sleep.
+*/
+static int freezer_enforce_write(struct pid *pid_ref, const char *value) {
+
+	struct file *filp;
+	loff_t pos = 0;
+	ssize_t ret;
+
+	filp = freezer_enforce_open(pid_ref, "cgroup.freeze", O_WRONLY, NULL);
+	if(IS_ERR(filp)) {
+		return PTR_ERR(filp);
+	}
+	ret = kernel_write(filp, value, strlen(value), &pos);
+	filp_close(filp, NULL);
+	return ret < 0 ? ret : 0;
+}
+
+/**
+	Function Name : freezer_enforce_run
+	Function Type : Enforcement Backend
+	Description   : Method thaws the cgroup of the task. Unlike a signal,
+					the freezer is not seen by the parent or job control.
+*/
+static int freezer_enforce_run(struct pid *pid_ref, int cpu) {
+
+	return freezer_enforce_write(pid_ref, "0");
+}
+
+/**
+	Function Name : freezer_enforce_stop
+	Function Type : Enforcement Backend
+	Description   : Method freezes the cgroup of the task.
+*/
+static int freezer_enforce_stop(struct pid *pid_ref, int cpu) {
+
+	return freezer_enforce_write(pid_ref, "1");
+}
+
+/**
+	Function Name : freezer_enforce_attach
+	Function Type : Enforcement Backend
+	Description   : Method checks the task has a cgroup with the freezer,
+					i.e. cgroup v2 on Linux 5.2 or later, and that nothing
+					but its own process is in it, as freezing the cgroup
+					freezes every process inside. -EBUSY otherwise.
+*/
+static int freezer_enforce_attach(struct pid *pid_ref) {
+
+	struct file *filp;
+	char buf[32], own[16];
+	loff_t pos = 0;
+	ssize_t len;
+	pid_t tgid;
+
+	filp = freezer_enforce_open(pid_ref, "cgroup.freeze", O_WRONLY, NULL);
+	if(IS_ERR(filp)) {
+		printk(KERN_ALERT "Process Queue ERROR:Process %d has no cgroup to freeze.\n", pid_nr(pid_ref));
+		return PTR_ERR(filp);
+	}
+	filp_close(filp, NULL);
+	filp = freezer_enforce_open(pid_ref, "cgroup.procs", O_RDONLY, &tgid);
+	if(IS_ERR(filp)) {
+		return PTR_ERR(filp);
+	}
+	len = kernel_read(filp, buf, sizeof(buf) - 1, &pos);
+	filp_close(filp, NULL);
+	if(len < 0) {
+		return len;
+	}
+	buf[len] = '\0';
+	snprintf(own, sizeof(own), "%d\n", tgid);
+	if(strcmp(buf, own) != 0) {
+		printk(KERN_ALERT "Process Queue ERROR:cgroup of Process %d holds other processes.\n", pid_nr(pid_ref));
+		return -EBUSY;
+	}
+	return 0;
+}
+
+/**
+	Function Name : freezer_enforce_detach
+	Function Type : Enforcement Backend
+	Description   : Method thaws the cgroup of a task leaving the queue.
+*/
+static void freezer_enforce_detach(struct pid *pid_ref) {
+
+	freezer_enforce_write(pid_ref, "0");
+}
+
+/**
+	Function Name : park_enforce_run
+	Function Type : Enforcement Backend
+	Description   : Method pins the task back to its CPU.
+*/
+static int park_enforce_run(struct pid *pid_ref, int cpu) {
+
+	return task_affinity_change(pid_ref, cpumask_of(cpu)) == eTaskStatusExist ? 0 : -ESRCH;
+}
+
+/**
+	Function Name : park_enforce_stop
+	Function Type : Enforcement Backend
+	Description   : Method parks the task on park_cpu, where it shares the
+					CPU with the other parked tasks instead of being stopped.
+					No process is placed on park_cpu, so the parked tasks
+					compete with none of the dispatched ones.
+*/
+static int park_enforce_stop(struct pid *pid_ref, int cpu) {
+
+	return task_affinity_change(pid_ref, cpumask_of(park_cpu)) == eTaskStatusExist ? 0 : -ESRCH;
+}
+
+/**
+	Function Name : task_cputime_ns
+	Function Type : Task level Accounting
+	Description   : Method returns the CPU time consumed by the task in
+					nanoseconds, or 0 if the task is gone. The kernel
+					scheduler accounts it to the nanosecond at every
+					switch and tick, unlike utime and stime which are
+					sampled per jiffy, so a slice shorter than a jiffy is
+					charged what it ran.
+*/
+u64 task_cputime_ns(struct pid *pid_ref) {
+
+	/**Task structure construct.*/
+	struct task_struct *current_pr;
+	u64 cputime = 0;
+
+	rcu_read_lock();
+	current_pr = pid_task(pid_ref, PIDTYPE_PID);
+	if(current_pr != NULL) {
+		cputime = READ_ONCE(current_pr->se.sum_exec_runtime);
+	}
+	rcu_read_unlock();
+	return cputime;
+}
+
+/**
+	Function Name : is_task_blocked
+	Function Type : Task level State
+	Description   : Method checks if the task is asleep, waiting for an
+					event. A stopped or runnable task is not blocked, nor
+					is a task that is gone.
+*/
+bool is_task_blocked(struct pid *pid_ref) {
+
+	/**Task structure construct.*/
+	struct task_struct *current_pr;
+	bool blocked = false;
+
+	rcu_read_lock();
+	current_pr = pid_task(pid_ref, PIDTYPE_PID);
+	if(current_pr != NULL) {
+		blocked = (READ_ONCE(current_pr->state) & (TASK_INTERRUPTIBLE | TASK_UNINTERRUPTIBLE)) != 0;
+	}
+	rcu_read_unlock();
+	return blocked;
+}
+
+/**
+	Function Name : task_affinity_change
+	Function Type : Task level Affinity change.
+	Description   : Method sets the CPUs the task is allowed to run on.
+					May sleep, must be called from process context.
+*/
+enum task_status_code task_affinity_change(struct pid *pid_ref, const struct cpumask *mask) {
+
+	/**Task structure construct.*/
+	struct task_struct *current_pr;
+	/**Obtain a counted task struct associated with provided pid reference.*/
+	current_pr = get_pid_task(pid_ref, PIDTYPE_PID);
+	/**Check if the task exists or not by checking for NULL Value.*/
+	if(current_pr == NULL) {
+		/**Return the task status code as terminated.*/
+		return eTaskStatusTerminated;
 	}
+	/**Restricting the task to the given CPUs.*/
+	set_cpus_allowed_ptr(current_pr, mask);
+	put_task_struct(current_pr);
 	/**Return the task status code as exists.*/
 	return eTaskStatusExist;
 }
 
 
+/**
+	Function Name : alloc_count_get
+	Function Type : Module Parameter Callback
+	Description   : Method reports the number of struct proc allocations
+			through /sys/module/process_queue/parameters/alloc_count.
+*/
+static int alloc_count_get(char *buffer, const struct kernel_param *kp)
+{
+	return sprintf(buffer, "%ld\n", atomic_long_read(&proc_alloc_count));
+}
+
+/** Read only parameter operations for the allocation counter. */
+static const struct kernel_param_ops alloc_count_ops = {
+	.get =	alloc_count_get,
+};
+
 /**
 	Function Name : process_queue_module_init
 	Function Type : Module INIT
@@ -480,16 +3647,63 @@ enum task_status_code task_status_change(int pid, enum process_state eState) {
 */
 static int __init process_queue_module_init(void)
 {
+	int i;
+
 	printk(KERN_INFO "Process Queue module is being loaded.\n");
-	/** Initializing the semaphores */
-	/** 
-		Setting Mutex used for critical section inside fifo modules
-		as 1. Indicates the critical section is free from use.
-	*/
-	sema_init(&mutex,1); 		
+
+	/**Selecting the enforcement backend, then the CPU the park backend parks on.*/
+	for(i = 0; i < ARRAY_SIZE(task_enforce_backends); i++) {
+		if(strcmp(enforce, task_enforce_backends[i].name) == 0) {
+			task_enforce = &task_enforce_backends[i];
+		}
+	}
+	if(task_enforce == NULL) {
+		printk(KERN_ERR "Process Queue ERROR:enforcement backend %s does not exist\n", enforce);
+		return -EINVAL;
+	}
+	if(park_cpu < 0) {
+		park_cpu = cpumask_last(cpu_online_mask);
+	}
+	if(park_cpu >= nr_cpu_ids || !cpu_online(park_cpu)) {
+		printk(KERN_ERR "Process Queue ERROR:park_cpu %d is not online\n", park_cpu);
+		return -EINVAL;
+	}
+	/**park_cpu is given up to the parked tasks, the processes need another one.*/
+	if(task_enforce->parks && num_online_cpus() < 2) {
+		printk(KERN_ERR "Process Queue ERROR:park backend needs a CPU besides park_cpu\n");
+		return -EINVAL;
+	}
+	printk(KERN_INFO "Process Queue enforcement backend is %s\n", task_enforce->name);
+
+	/**Creating the slab cache for the process info nodes.*/
+	proc_cache = kmem_cache_create("process_queue_proc", sizeof(struct proc), 0, SLAB_HWCACHE_ALIGN, NULL);
+	if(proc_cache == NULL) {
+		printk(KERN_ERR "Process Queue ERROR:slab cache cannot be allocated\n");
+		/** Memory Allocation Problem */
+		return -ENOMEM;
+	}
 	
 	/**Initializing the process queue*/
-	init_process_queue();
+	if(init_process_queue() != 0) {
+		kmem_cache_destroy(proc_cache);
+		return -ENOMEM;
+	}
+
+	/**
+		Hooking task exit, sleep, wakeup and fork. Without the exit probe
+		the run queues poll for dead tasks, without the wakeup probe a
+		sleeping process keeps its slice, without the fork probe
+		follow_fork has no effect.
+	*/
+	for_each_kernel_tracepoint(find_queue_tracepoints, NULL);
+	for(i = 0; i < eProbeCount; i++) {
+		if(queue_probes[i].tp != NULL && tracepoint_probe_register(queue_probes[i].tp, queue_probes[i].probe, NULL) != 0) {
+			queue_probes[i].tp = NULL;
+		}
+		if(queue_probes[i].tp == NULL) {
+			printk(KERN_ALERT "Process Queue ERROR:%s cannot be hooked.\n", queue_probes[i].name);
+		}
+	}
 
 	return 0;
 }
@@ -503,9 +3717,29 @@ static int __init process_queue_module_init(void)
 */
 static void __exit process_queue_module_cleanup(void)
 {
+	int i, cpu;
+
 	printk(KERN_INFO "Process Queue module is being unloaded.\n");
+	/**Unhooking the tracepoints and waiting for the probes still running.*/
+	for(i = 0; i < eProbeCount; i++) {
+		if(queue_probes[i].tp != NULL) {
+			tracepoint_probe_unregister(queue_probes[i].tp, queue_probes[i].probe, NULL);
+		}
+	}
+	tracepoint_synchronize_unregister();
+	/**Continuing the children still queued for registration.*/
+	cancel_work_sync(&fork_work);
+	drain_forked_processes(false);
+	/**Waiting for the wakeups they queued.*/
+	for_each_possible_cpu(cpu) {
+		irq_work_sync(&per_cpu_ptr(&proc_rqs, cpu)->wake_work);
+	}
 	/**Releasing the process queue.*/
 	release_process_queue();
+	/**Waiting for the pending RCU callbacks to return every node.*/
+	rcu_barrier();
+	/**Destroying the slab cache once every node is returned.*/
+	kmem_cache_destroy(proc_cache);
 }
 /** Initializing the kernel module init with custom init method */
 module_init(process_queue_module_init);
@@ -515,8 +3749,39 @@ module_exit(process_queue_module_cleanup);
 EXPORT_SYMBOL_GPL(init_process_queue);
 EXPORT_SYMBOL_GPL(release_process_queue);
 EXPORT_SYMBOL_GPL(add_process_to_queue);
+EXPORT_SYMBOL_GPL(add_process_to_queue_attr);
 EXPORT_SYMBOL_GPL(remove_process_from_queue);
+EXPORT_SYMBOL_GPL(rotate_process_queue);
 EXPORT_SYMBOL_GPL(print_process_queue);
+EXPORT_SYMBOL_GPL(print_process_queue_stats);
 EXPORT_SYMBOL_GPL(get_first_process_in_queue);
 EXPORT_SYMBOL_GPL(change_process_state_in_queue);
-EXPORT_SYMBOL_GPL(remove_terminated_processes_from_queue);
\ No newline at end of file
+EXPORT_SYMBOL_GPL(remove_terminated_processes_from_queue);
+EXPORT_SYMBOL_GPL(switch_process_in_queue);
+EXPORT_SYMBOL_GPL(steal_process_to_cpu);
+EXPORT_SYMBOL_GPL(get_run_queue_load);
+EXPORT_SYMBOL_GPL(fifo_enqueue_process);
+EXPORT_SYMBOL_GPL(fifo_dequeue_process);
+EXPORT_SYMBOL_GPL(fifo_pick_next_process);
+EXPORT_SYMBOL_GPL(set_process_queue_policy);
+EXPORT_SYMBOL_GPL(add_process_group);
+EXPORT_SYMBOL_GPL(remove_process_group);
+EXPORT_SYMBOL_GPL(process_group_total_weight);
+EXPORT_SYMBOL_GPL(set_process_queue_resched);
+EXPORT_SYMBOL_GPL(yield_process_in_queue);
+EXPORT_TRACEPOINT_SYMBOL_GPL(process_sched_register);
+EXPORT_TRACEPOINT_SYMBOL_GPL(process_sched_dispatch);
+EXPORT_TRACEPOINT_SYMBOL_GPL(process_sched_preempt);
+EXPORT_TRACEPOINT_SYMBOL_GPL(process_sched_reap);
+EXPORT_TRACEPOINT_SYMBOL_GPL(process_sched_tick);
+
+/**Initializing the following of the children of registered processes, writable at run time*/
+module_param(follow_fork, bool, 0644);
+/**Initializing the enforcement backend, signal, freezer or park, fixed at load time*/
+module_param(enforce, charp, 0444);
+/**Initializing the cgroup v2 mount point of the freezer backend*/
+module_param(cgroup_mount, charp, 0444);
+/**Initializing the parking CPU of the park backend*/
+module_param(park_cpu, int, 0444);
+/**Exposing the allocation counter as a read only parameter.*/
+module_param_cb(alloc_count, &alloc_count_ops, NULL, 0444);
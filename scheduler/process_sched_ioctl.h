@@ -0,0 +1,55 @@
+/**
+	\file	:	process_sched_ioctl.h
+	\author	: 	Sreeram Sadasivam
+	\brief	:	Binary interface of the /dev/process_sched character device,
+				shared by the process_set module and user space. A single
+				ioctl registers or removes a whole array of pids, each with
+				optional scheduling attributes, and reports a result per pid.
+*/
+#ifndef _PROCESS_SCHED_IOCTL_H
+#define _PROCESS_SCHED_IOCTL_H
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+/**Name of the device node under /dev.*/
+#define PROC_SCHED_DEV_NAME		"process_sched"
+/**Largest number of pids of one batch.*/
+#define PROC_SCHED_BATCH_MAX	65536
+/**Longest group name, terminating NUL included.*/
+#define PROC_SCHED_GROUP_MAX	16
+
+/**
+	Structure for the scheduling attributes of one pid, the binary form of
+	the key=value fields of /proc/process_sched_add. All zero registers a
+	plain process. A zero deadline defaults to the period.
+*/
+struct proc_sched_ioc_attr {
+
+	__u64 runtime_us;					/**CPU time reserved in every period, 0 without a reservation.*/
+	__u64 period_us;					/**Period of the reservation.*/
+	__u64 deadline_us;					/**Deadline relative to the start of every period.*/
+	__u32 tickets;						/**Weight within the proportional share policies, 0 for the default.*/
+	__u32 pad;							/**Must be zero.*/
+	char group[PROC_SCHED_GROUP_MAX];	/**Group of the process, empty for the default group.*/
+};
+
+/**
+	Structure for a batch. The pointers are user addresses cast to __u64
+	so that 32 and 64 bit callers share the layout.
+*/
+struct proc_sched_ioc_batch {
+
+	__u64 pids;			/**Array of count __s32 pids.*/
+	__u64 attrs;		/**Array of count attributes, 0 for none. Add only.*/
+	__u64 results;		/**Array of count __s32 results, 0 or -errno per pid, 0 for none.*/
+	__u32 count;		/**Number of pids, at most PROC_SCHED_BATCH_MAX.*/
+	__u32 done;			/**Set to the number of pids processed successfully.*/
+};
+
+/**ioctl commands*/
+#define PROC_SCHED_IOC_MAGIC	'k'
+#define PROC_SCHED_IOC_ADD		_IOWR(PROC_SCHED_IOC_MAGIC, 1, struct proc_sched_ioc_batch)
+#define PROC_SCHED_IOC_REMOVE	_IOWR(PROC_SCHED_IOC_MAGIC, 2, struct proc_sched_ioc_batch)
+
+#endif
@@ -0,0 +1,138 @@
+/**
+	\file	:	process_sched_trace.h
+	\author	: 	Sreeram Sadasivam
+	\brief	:	Trace events of the LKM scheduler, under the process_sched
+				system of tracefs. A disabled event costs a static branch.
+				They are created in process_queue.c and exported to the
+				other modules.
+*/
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM process_sched
+
+#if !defined(_PROCESS_SCHED_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _PROCESS_SCHED_TRACE_H
+
+#include <linux/tracepoint.h>
+#include "sched_policy.h"
+
+/**A process joins the run queue of a CPU.*/
+TRACE_EVENT(process_sched_register,
+
+	TP_PROTO(int pid, int cpu, const char *group, u64 runtime_ns),
+
+	TP_ARGS(pid, cpu, group, runtime_ns),
+
+	TP_STRUCT__entry(
+		__field(int, pid)
+		__field(int, cpu)
+		__array(char, group, SCHED_GROUP_NAME_MAX)
+		__field(u64, runtime_ns)
+	),
+
+	TP_fast_assign(
+		__entry->pid = pid;
+		__entry->cpu = cpu;
+		strscpy(__entry->group, group, SCHED_GROUP_NAME_MAX);
+		__entry->runtime_ns = runtime_ns;
+	),
+
+	TP_printk("pid=%d cpu=%d group=%s runtime_ns=%llu",
+		__entry->pid, __entry->cpu, __entry->group, __entry->runtime_ns)
+);
+
+/**A switch of a CPU, next_pid runs for slice_ns, -1 for none.*/
+TRACE_EVENT(process_sched_dispatch,
+
+	TP_PROTO(int cpu, int prev_pid, int next_pid, u64 slice_ns),
+
+	TP_ARGS(cpu, prev_pid, next_pid, slice_ns),
+
+	TP_STRUCT__entry(
+		__field(int, cpu)
+		__field(int, prev_pid)
+		__field(int, next_pid)
+		__field(u64, slice_ns)
+	),
+
+	TP_fast_assign(
+		__entry->cpu = cpu;
+		__entry->prev_pid = prev_pid;
+		__entry->next_pid = next_pid;
+		__entry->slice_ns = slice_ns;
+	),
+
+	TP_printk("cpu=%d prev_pid=%d next_pid=%d slice_ns=%llu",
+		__entry->cpu, __entry->prev_pid, __entry->next_pid, __entry->slice_ns)
+);
+
+/**A new or woken process preempts the running one.*/
+TRACE_EVENT(process_sched_preempt,
+
+	TP_PROTO(int cpu, int curr_pid, int pid),
+
+	TP_ARGS(cpu, curr_pid, pid),
+
+	TP_STRUCT__entry(
+		__field(int, cpu)
+		__field(int, curr_pid)
+		__field(int, pid)
+	),
+
+	TP_fast_assign(
+		__entry->cpu = cpu;
+		__entry->curr_pid = curr_pid;
+		__entry->pid = pid;
+	),
+
+	TP_printk("cpu=%d curr_pid=%d pid=%d",
+		__entry->cpu, __entry->curr_pid, __entry->pid)
+);
+
+/**A process whose task is gone leaves the run queue of a CPU.*/
+TRACE_EVENT(process_sched_reap,
+
+	TP_PROTO(int pid, int cpu),
+
+	TP_ARGS(pid, cpu),
+
+	TP_STRUCT__entry(
+		__field(int, pid)
+		__field(int, cpu)
+	),
+
+	TP_fast_assign(
+		__entry->pid = pid;
+		__entry->cpu = cpu;
+	),
+
+	TP_printk("pid=%d cpu=%d", __entry->pid, __entry->cpu)
+);
+
+/**An expiry of the dispatch timer of a CPU, late_ns after its deadline.*/
+TRACE_EVENT(process_sched_tick,
+
+	TP_PROTO(int cpu, u64 late_ns),
+
+	TP_ARGS(cpu, late_ns),
+
+	TP_STRUCT__entry(
+		__field(int, cpu)
+		__field(u64, late_ns)
+	),
+
+	TP_fast_assign(
+		__entry->cpu = cpu;
+		__entry->late_ns = late_ns;
+	),
+
+	TP_printk("cpu=%d late_ns=%llu", __entry->cpu, __entry->late_ns)
+);
+
+#endif
+
+/**The header is read again from this directory to create the events.*/
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE process_sched_trace
+#include <trace/define_trace.h>
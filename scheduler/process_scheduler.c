@@ -12,39 +12,86 @@
 #include <linux/kernel.h>
 #include <linux/list.h>
 #include <linux/slab.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
+#include <linux/moduleparam.h>
+#include <linux/percpu.h>
 #include <linux/workqueue.h>
 #include <linux/sched.h>
+#include <linux/string.h>
+#include <linux/mutex.h>
+#include <linux/irq_work.h>
+#include <linux/smp.h>
+#include "sched_policy.h"
+#include "process_sched_trace.h"
 
 MODULE_AUTHOR("Sreeram Sadasivam");
 MODULE_DESCRIPTION("Process Scheduler Module");
 MODULE_LICENSE("GPL");
 
 /**Macros*/
-#define ALL_REG_PIDS	-100
-
-/**Enumeration for Process States*/
-enum process_state {
-	
-	eCreated		=	0, /**Process in Created State*/
-	eRunning		=	1, /**Process in Running State*/
-	eWaiting		=	2, /**Process in Waiting State*/
-	eBlocked		=	3, /**Process in Blocked State*/
-	eTerminated		=	4  /**Process in Terminate State*/
-};
-
-
+/**Smallest accepted time slice, guards against a timer storm.*/
+#define MIN_TIME_QUANTUM_US	50
+/**Names of the built in scheduling policies.*/
+#define POLICY_STATIC_RR	"static_rr"
+#define POLICY_DYNAMIC_RR	"dynamic_rr"
 
 /**External Function Prototypes for Process Queue Functions*/
 extern int add_process_to_queue(int pid);
 extern int remove_process_from_queue(int pid);
+extern int rotate_process_queue(int pid);
 extern int print_process_queue(void);
 extern int change_process_state_in_queue(int pid, int changeState);
 extern int get_first_process_in_queue(void);
 extern int remove_terminated_processes_from_queue(void);
+extern int switch_process_in_queue(int cpu, u64 *slice_ns);
+extern int steal_process_to_cpu(int cpu);
+extern void set_process_queue_resched(void (*resched)(int cpu, bool now));
+
+/**Structure for the measured tick jitter, i.e. timer expiry lateness.*/
+struct tick_jitter {
+
+	unsigned long samples;		/**Number of ticks measured.*/
+	u64 total_ns;				/**Sum of the lateness of all ticks.*/
+	u64 min_ns;					/**Smallest lateness seen.*/
+	u64 max_ns;					/**Largest lateness seen.*/
+	unsigned long overruns;		/**Quanta skipped because a tick came too late.*/
+	unsigned long kicks;		/**Switches requested before the end of the slice.*/
+	unsigned long stops;		/**Ticks stopped because nothing waited.*/
+};
+
+/** Structure for the scheduler instance of one CPU */
+struct sched_cpu {
+
+	/**
+		High resolution timer driving the dispatch of the CPU. It expires
+		on an absolute grid of quantum_ns, so workqueue latency and jiffy
+		rounding do not accumulate into drift.
+	*/
+	struct hrtimer timer;
+	struct work_struct steal_work;	/**Work pulling a process to the CPU when it is idle.*/
+	struct irq_work kick_work;		/**Interrupt work firing the timer at once on the CPU.*/
+	int cpu;						/**CPU served by the instance.*/
+	int current_pid;				/**Process running on the CPU.*/
+	u64 slice_ns;					/**Time slice of the running process.*/
+	ktime_t slice_start;			/**Time of the last switch, the slice runs from there.*/
+	bool tickless;					/**The timer is stopped until the process queue asks for a switch.*/
+	bool kick_now;					/**The pending kick switches at once, else it restarts the timer.*/
+	struct tick_jitter jitter;		/**Tick jitter measured on the CPU.*/
+};
 
 /**Function Prototype for Scheduler*/
-static void context_switch(struct work_struct *w);
-int static_round_robin_scheduling(void);
+static enum hrtimer_restart context_switch(struct hrtimer *timer);
+static void idle_balance(struct work_struct *w);
+static void start_sched_cpu(void *info);
+static void kick_sched_cpu(struct irq_work *work);
+static void resched_sched_cpu(int cpu, bool now);
+int policy_scheduling(struct sched_cpu *sc);
+static u64 dynamic_rr_timeslice(struct proc_rq *rq, struct proc *curr);
+static struct sched_policy_ops *find_sched_policy(const char *name);
+static int activate_sched_policy(const char *name);
+int register_sched_policy(struct sched_policy_ops *ops);
+void unregister_sched_policy(struct sched_policy_ops *ops);
 
 /**Flags*/
 static int flag = 0;
@@ -52,90 +99,394 @@ static int flag = 0;
 /**Time Quantum storage variable for pre-emptive based schedulers.*/
 static int time_quantum=3;
 
-/**Current PID*/
-static int current_pid = -1;
+/**
+	Time Quantum in microseconds. When non zero it overrides time_quantum
+	and allows sub second time slices.
+*/
+static unsigned long time_quantum_us = 0;
 
-/** WorkQueue Object */
-struct workqueue_struct *scheduler_wq;
+/**Effective time slice in nanoseconds, computed at load time.*/
+static u64 quantum_ns;
 
+/**
+	Name of the scheduling policy, set at load time and changed at run time
+	through /sys/module/process_scheduler/parameters/policy.
+*/
+static char policy_name[SCHED_POLICY_NAME_MAX] = POLICY_STATIC_RR;
+
+/**Registered scheduling policies, the built in ones first.*/
+static LIST_HEAD(policy_list);
+
+/**Policy installed on the process queue, NULL until the module is initialized.*/
+static struct sched_policy_ops *active_policy;
+
+/**Mutex serializing the registry and the policy switches.*/
+static DEFINE_MUTEX(policy_mutex);
+
+/**Bounds of the dynamic round robin time slice in microseconds.*/
+static unsigned long drr_min_quantum_us = 1000;
+static unsigned long drr_max_quantum_us = 10000000;
+
+/**
+	Run queue length at which the dynamic round robin slice equals the
+	base quantum. Longer queues get proportionally longer slices.
+*/
+static unsigned int drr_ref_len = 4;
+
+/** Per run queue data of the dynamic round robin policy. */
+struct dynamic_rr_rq {
+
+	u64 slice_ns;				/**Time slice of the current round.*/
+	unsigned int round_left;	/**Switches left before the round ends.*/
+};
+
+/**Static round robin, every process gets the same time quanta.*/
+static struct sched_policy_ops static_rr_policy = {
+	.name		= POLICY_STATIC_RR,
+	.owner		= THIS_MODULE,
+	.enqueue	= fifo_enqueue_process,
+	.dequeue	= fifo_dequeue_process,
+	.pick_next	= fifo_pick_next_process,
+};
+
+/**Dynamic round robin, the time slice follows the run queue load.*/
+static struct sched_policy_ops dynamic_rr_policy = {
+	.name			= POLICY_DYNAMIC_RR,
+	.owner			= THIS_MODULE,
+	.rq_priv_size	= sizeof(struct dynamic_rr_rq),
+	.enqueue		= fifo_enqueue_process,
+	.dequeue		= fifo_dequeue_process,
+	.pick_next		= fifo_pick_next_process,
+	.timeslice		= dynamic_rr_timeslice,
+};
+
+/**One scheduler instance per CPU, each dispatching its own run queue.*/
+static DEFINE_PER_CPU(struct sched_cpu, sched_cpus);
 
-/** Creating a delayed_work object with the provided function handler.*/
-static DECLARE_DELAYED_WORK(scheduler_hdlr, context_switch);
 /**
 	Function Name : context_switch
 	Function Type : Internal Method
 	Description   : Method which is invoked to switch the currently executing
 					process with another process. The method internally calls
-					the provided scheduling policy.
+					the provided scheduling policy. Runs in hard interrupt
+					context as the callback of the timer of one CPU.
 */
-static void context_switch(struct work_struct *w){
-	
-	/** Boolean status of the queue.*/
-	bool q_status=false;
+static enum hrtimer_restart context_switch(struct hrtimer *timer){
 	
-	printk(KERN_ALERT "Scheduler instance: Context Switch\n");
+	struct sched_cpu *sc = container_of(timer, struct sched_cpu, timer);
+	struct tick_jitter *jitter = &sc->jitter;
+	/**Time of this expiry and its lateness against the programmed deadline.*/
+	ktime_t now = hrtimer_cb_get_time(timer);
+	u64 late_ns = ktime_to_ns(ktime_sub(now, hrtimer_get_expires(timer)));
+	u64 overruns;
 
-	/**Invoking the static round robin scheduling policy.*/
-	static_round_robin_scheduling();
+	/**Accounting the tick jitter.*/
+	jitter->samples++;
+	jitter->total_ns += late_ns;
+	if(late_ns < jitter->min_ns) {
+		jitter->min_ns = late_ns;
+	}
+	if(late_ns > jitter->max_ns) {
+		jitter->max_ns = late_ns;
+	}
+
+	trace_process_sched_tick(sc->cpu, late_ns);
+
+	/**Invoking the scheduling policy installed on the process queue.*/
+	policy_scheduling(sc);
 
 	/** Condition check for producer unloading flag set or not.*/
 	if (flag == 0){
-		/** Setting the delayed work execution for the provided rate */
-		q_status = queue_delayed_work(scheduler_wq, &scheduler_hdlr, time_quantum*HZ);
+		/**An idle CPU tries to pull work from the busiest run queue.*/
+		if(sc->current_pid == INVALID_PID) {
+			queue_work_on(sc->cpu, system_wq, &sc->steal_work);
+		}
+		sc->slice_start = now;
+		/**
+			Nothing waits on the CPU, the timer stays off until the process
+			queue asks for a switch. A lone process runs with no tick.
+		*/
+		if(sc->slice_ns == SCHED_SLICE_TICKLESS) {
+			sc->tickless = true;
+			jitter->stops++;
+			return HRTIMER_NORESTART;
+		}
+		/**
+			Moving the deadline forward by whole quanta from the previous
+			deadline, not from now, so the lateness of this tick is not
+			carried into the next one.
+		*/
+		overruns = hrtimer_forward(timer, now, ns_to_ktime(sc->slice_ns));
+		if(overruns > 1) {
+			jitter->overruns += overruns - 1;
+		}
+		return HRTIMER_RESTART;
 	}
-	else
-		printk(KERN_ALERT "Scheduler instance: scheduler is unloading\n");
+	pr_debug("Scheduler instance: scheduler is unloading\n");
+	return HRTIMER_NORESTART;
 }
 
 /**
-	Function Name : static_round_robin_scheduling
-	Function Type : Scheduling Scheme
-	Description   : Method for static round robin scheduling scheme.
+	Function Name : idle_balance
+	Function Type : Internal Method
+	Description   : Work item of an idle CPU. Steals one waiting process from
+					the busiest run queue, it is dispatched on the next tick.
 */
-int static_round_robin_scheduling(void)
-{
-	/**Storage class variable to detecting the process state change.*/
-	int ret_process_state=-1;
+static void idle_balance(struct work_struct *w){
 
-	printk(KERN_INFO "Static Round Robin Scheduling scheme.\n");
-	
-	/**Removing all terminated process from the queue.*/
-	remove_terminated_processes_from_queue();
+	struct sched_cpu *sc = container_of(w, struct sched_cpu, steal_work);
+
+	if(flag == 0) {
+		steal_process_to_cpu(sc->cpu);
+	}
+}
+
+/**
+	Function Name : start_sched_cpu
+	Function Type : Internal Method
+	Description   : Arms the dispatch timer of the calling CPU. Invoked on
+					every online CPU so that each timer is pinned to its CPU.
+*/
+static void start_sched_cpu(void *info){
+
+	struct sched_cpu *sc = this_cpu_ptr(&sched_cpus);
+
+	/** Setting the first deadline one quantum from now.*/
+	hrtimer_start(&sc->timer, ktime_add_ns(ktime_get(), quantum_ns), HRTIMER_MODE_ABS_PINNED);
+}
+
+/**
+	Function Name : kick_sched_cpu
+	Function Type : Internal Method
+	Description   : Interrupt work run on the CPU to switch. Moves the
+					dispatch timer to now, the switch runs as soon as the
+					work returns and the slices restart from there. A
+					request to restart a stopped timer is ignored while it
+					runs, and otherwise restarts it where the quantum of the
+					process running alone ends, it may have just been
+					dispatched.
+*/
+static void kick_sched_cpu(struct irq_work *work){
+
+	struct sched_cpu *sc = container_of(work, struct sched_cpu, kick_work);
+	ktime_t expires = ktime_get();
+	bool now = xchg(&sc->kick_now, false);
 
-	/**Check if the current process id is INVALID or not.*/
-	if(current_pid != -1) {
-		/**Add the current process to the process queue.*/	
-		add_process_to_queue(current_pid);	
+	if(flag != 0 || (!now && !sc->tickless)) {
+		return;
+	}
+	if(now) {
+		sc->jitter.kicks++;
 	}
+	else if(sc->current_pid != INVALID_PID && ktime_after(ktime_add_ns(sc->slice_start, quantum_ns), expires)) {
+		expires = ktime_add_ns(sc->slice_start, quantum_ns);
+	}
+	sc->tickless = false;
+	hrtimer_start(&sc->timer, expires, HRTIMER_MODE_ABS_PINNED);
+}
+
+/**
+	Function Name : resched_sched_cpu
+	Function Type : Internal Method
+	Description   : Callback of the process queue asking the given CPU to
+					switch before its slice ends, e.g. when its running
+					process exits or a new process preempts it, or with now
+					false to restart its stopped timer. The timer is pinned,
+					so it is moved from the CPU itself through interrupt
+					work. Usable from atomic context.
+*/
+static void resched_sched_cpu(int cpu, bool now){
+
+	struct sched_cpu *sc = per_cpu_ptr(&sched_cpus, cpu);
+
+	/**Seen by the interrupt work, queueing it is a full barrier.*/
+	if(now) {
+		WRITE_ONCE(sc->kick_now, true);
+	}
+	if(cpu == get_cpu()) {
+		irq_work_queue(&sc->kick_work);
+	}
+	else {
+		irq_work_queue_on(&sc->kick_work, cpu);
+	}
+	put_cpu();
+}
+
+/**
+	Function Name : policy_scheduling
+	Function Type : Scheduling Scheme
+	Description   : Method for the scheduling scheme on the run queue of one
+					CPU. The policy installed on the process queue orders the
+					waiting processes and may ask for its own time slice.
+*/
+int policy_scheduling(struct sched_cpu *sc)
+{
+	u64 slice_ns;
 
-	/** Obtaining the first process in the wait queue.*/
-	current_pid = get_first_process_in_queue();
 	/**
-		Check if the obtained process id is invalid or not. If Invalid indicates,
-		the queue does not contain any active process.
+		Giving the current process back to the policy, reaping terminated
+		processes and dispatching the process picked by the policy, all
+		under a single acquisition of the run queue lock.
 	*/
-	if(current_pid != -1) {
-		/**Change the process state of the obtained process from queue to running.*/
-		ret_process_state = change_process_state_in_queue(current_pid, eRunning);
-		/**Remove the process from the waiting queue.*/
-		remove_process_from_queue(current_pid);
+	sc->current_pid = switch_process_in_queue(sc->cpu, &slice_ns);
+	sc->slice_ns = slice_ns != 0 ? slice_ns : quantum_ns;
+
+	pr_debug("Currently running process on CPU %d: %d\n", sc->cpu, sc->current_pid);
+
+	/** Successful execution of the method. */
+	return 0;
+}
+
+/**
+	Function Name : dynamic_rr_timeslice
+	Function Type : Policy Hook
+	Description   : Time slice hook of the dynamic round robin policy. The
+					slice is recomputed once per round, i.e. once every
+					process of the run queue had a turn. It grows with the
+					run queue length, which cuts the switch overhead of long
+					queues, and is capped near the CPU time the processes
+					actually used in their last slice, which cuts the
+					response time when they give the CPU up early.
+*/
+static u64 dynamic_rr_timeslice(struct proc_rq *rq, struct proc *curr)
+{
+	struct dynamic_rr_rq *drr = rq->policy_priv;
+	unsigned int nr_procs = rq->nr_procs;
+	u64 avg_burst_ns, slice_ns;
+
+	if(curr == NULL) {
+		/**Nothing runs, nothing to switch at the end of a round.*/
+		return 0;
 	}
-	
-	printk(KERN_INFO "Currently running process: %d\n", current_pid);
+	/**Check if the round is over.*/
+	if(drr->round_left > 0) {
+		drr->round_left--;
+		return drr->slice_ns;
+	}
+	avg_burst_ns = nr_procs ? div64_u64(rq->burst_sum_ns, nr_procs) : 0;
+	/**Length term, base quantum scaled by the run queue length.*/
+	slice_ns = div_u64(quantum_ns * max(nr_procs, 1U), drr_ref_len);
+	/**Burst term, a quarter of headroom above the average used CPU time.*/
+	if(avg_burst_ns != 0) {
+		slice_ns = min(slice_ns, avg_burst_ns + avg_burst_ns / 4);
+	}
+	drr->slice_ns = clamp_t(u64, slice_ns, (u64)drr_min_quantum_us * NSEC_PER_USEC, (u64)drr_max_quantum_us * NSEC_PER_USEC);
+	drr->round_left = nr_procs ? nr_procs - 1 : 0;
+
+	pr_debug("Dynamic Round Robin on CPU %d: %u processes, average burst %llu ns, slice %llu ns\n",
+		rq->cpu, nr_procs, avg_burst_ns, drr->slice_ns);
+	return drr->slice_ns;
+}
 
-	/**Check if there no processes active in the scheduler or not.*/
-	if(current_pid != -1) {
-		printk(KERN_INFO "Current Process Queue...\n");
-		/**Print the wait queue.*/
-		print_process_queue();
-		printk(KERN_INFO "Currently running process: %d\n", current_pid);
+/**
+	Function Name : find_sched_policy
+	Function Type : Policy Registry
+	Description   : Method returns the registered policy of the given name
+					or NULL. Caller must hold the policy mutex.
+*/
+static struct sched_policy_ops *find_sched_policy(const char *name)
+{
+	struct sched_policy_ops *ops;
+
+	list_for_each_entry(ops, &policy_list, list) {
+		if(strcmp(ops->name, name) == 0) {
+			return ops;
+		}
 	}
-	
-	
-	/** Successful execution of the method. */
+	return NULL;
+}
+
+/**
+	Function Name : register_sched_policy
+	Function Type : Policy Registry
+	Description   : Method makes a policy selectable by its name. Called by
+					the policy modules from their init method, the policy
+					is not installed until it is selected.
+*/
+int register_sched_policy(struct sched_policy_ops *ops)
+{
+	if(ops->enqueue == NULL || ops->dequeue == NULL || ops->pick_next == NULL) {
+		printk(KERN_ERR "Scheduler instance ERROR:policy %s misses a mandatory hook\n", ops->name);
+		return -EINVAL;
+	}
+	mutex_lock(&policy_mutex);
+	if(find_sched_policy(ops->name) != NULL) {
+		mutex_unlock(&policy_mutex);
+		printk(KERN_ERR "Scheduler instance ERROR:policy %s is already registered\n", ops->name);
+		return -EEXIST;
+	}
+	list_add_tail(&ops->list, &policy_list);
+	mutex_unlock(&policy_mutex);
+
+	printk(KERN_INFO "Process Scheduler policy %s registered\n", ops->name);
 	return 0;
 }
 
+/**
+	Function Name : unregister_sched_policy
+	Function Type : Policy Registry
+	Description   : Method removes a policy from the registry. Called by the
+					policy modules from their cleanup method. The installed
+					policy holds a reference on its module, so it is never
+					the one removed.
+*/
+void unregister_sched_policy(struct sched_policy_ops *ops)
+{
+	mutex_lock(&policy_mutex);
+	list_del(&ops->list);
+	mutex_unlock(&policy_mutex);
+
+	printk(KERN_INFO "Process Scheduler policy %s unregistered\n", ops->name);
+}
+
+/**
+	Function Name : activate_sched_policy
+	Function Type : Policy Registry
+	Description   : Method installs the policy of the given name on the
+					process queue. The registered processes are kept, the
+					queue moves the waiting ones from the old policy to the
+					new one. The installed policy module is pinned until
+					another policy replaces it.
+*/
+static int activate_sched_policy(const char *name)
+{
+	struct sched_policy_ops *ops;
+	int ret;
+
+	mutex_lock(&policy_mutex);
+	ops = find_sched_policy(name);
+	if(ops == NULL) {
+		mutex_unlock(&policy_mutex);
+		printk(KERN_ERR "Scheduler instance ERROR:unknown policy %s\n", name);
+		return -EINVAL;
+	}
+	if(ops == active_policy) {
+		mutex_unlock(&policy_mutex);
+		return 0;
+	}
+	/**The built in policies live as long as the scheduler itself.*/
+	if(ops->owner != THIS_MODULE && !try_module_get(ops->owner)) {
+		mutex_unlock(&policy_mutex);
+		return -ENODEV;
+	}
+	ret = set_process_queue_policy(ops);
+	if(ret != 0) {
+		if(ops->owner != THIS_MODULE) {
+			module_put(ops->owner);
+		}
+		mutex_unlock(&policy_mutex);
+		return ret;
+	}
+	if(active_policy != NULL && active_policy->owner != THIS_MODULE) {
+		module_put(active_policy->owner);
+	}
+	active_policy = ops;
+	strscpy(policy_name, ops->name, sizeof(policy_name));
+	mutex_unlock(&policy_mutex);
+
+	printk(KERN_INFO "Process Scheduler policy: %s\n", policy_name);
+	return 0;
+}
 
 /**
 	Function Name : process_scheduler_module_init
@@ -146,31 +497,59 @@ int static_round_robin_scheduling(void)
 */
 static int __init process_scheduler_module_init(void)
 {
-	/** Boolean status of the queue.*/
-	bool q_status=false;
+	struct sched_cpu *sc;
+	int cpu, ret;
 
 	printk(KERN_INFO "Process Scheduler module is being loaded.\n");
-	
-	/**
-		Allocating the workqueue under the name scheduler-wq and max 1
-		active schedulers.
-	*/
-	scheduler_wq = alloc_workqueue("scheduler-wq", WQ_UNBOUND, 1);
 
-	/** Condition check if the workqueue allocation failed */
-	if (scheduler_wq== NULL){
-		
-		printk(KERN_ERR "Scheduler instance ERROR:Workqueue cannot be allocated\n");
-		/** Memory Allocation Problem */
-		return -ENOMEM;
+	/**Computing the time slice from the module parameters.*/
+	if(time_quantum_us != 0) {
+		if(time_quantum_us < MIN_TIME_QUANTUM_US) {
+			printk(KERN_ERR "Scheduler instance ERROR:time_quantum_us must be at least %d\n", MIN_TIME_QUANTUM_US);
+			return -EINVAL;
+		}
+		quantum_ns = (u64)time_quantum_us * NSEC_PER_USEC;
 	}
 	else {
-		/** Performing an internal call for context_switch */
-		//context_switch();
-		/** Setting the delayed work execution for the provided rate */
-		q_status = queue_delayed_work(scheduler_wq, &scheduler_hdlr, time_quantum*HZ);
+		if(time_quantum <= 0) {
+			printk(KERN_ERR "Scheduler instance ERROR:time_quantum must be positive\n");
+			return -EINVAL;
+		}
+		quantum_ns = (u64)time_quantum * NSEC_PER_SEC;
 	}
 
+	if(drr_ref_len == 0 || drr_min_quantum_us < MIN_TIME_QUANTUM_US || drr_min_quantum_us > drr_max_quantum_us) {
+		printk(KERN_ERR "Scheduler instance ERROR:invalid dynamic round robin parameters\n");
+		return -EINVAL;
+	}
+
+	/**Registering the built in policies and installing the selected one.*/
+	register_sched_policy(&static_rr_policy);
+	register_sched_policy(&dynamic_rr_policy);
+	ret = activate_sched_policy(policy_name);
+	if(ret != 0) {
+		unregister_sched_policy(&dynamic_rr_policy);
+		unregister_sched_policy(&static_rr_policy);
+		return ret;
+	}
+	
+	/**Initializing the scheduler instance of every CPU.*/
+	for_each_possible_cpu(cpu) {
+		sc = per_cpu_ptr(&sched_cpus, cpu);
+		sc->cpu = cpu;
+		sc->current_pid = INVALID_PID;
+		sc->slice_ns = quantum_ns;
+		sc->jitter.min_ns = U64_MAX;
+		/**Initializing the dispatch timer on absolute deadlines.*/
+		hrtimer_init(&sc->timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS_PINNED);
+		sc->timer.function = context_switch;
+		INIT_WORK(&sc->steal_work, idle_balance);
+		init_irq_work(&sc->kick_work, kick_sched_cpu);
+	}
+	/**Arming the timers, each one on its own CPU.*/
+	on_each_cpu(start_sched_cpu, NULL, 1);
+	/**Letting the process queue cut a slice short.*/
+	set_process_queue_resched(resched_sched_cpu);
 
 	/** Successful execution of initialization method. */
 	return 0;
@@ -185,21 +564,157 @@ static int __init process_scheduler_module_init(void)
 */
 static void __exit process_scheduler_module_cleanup(void)
 {
+	struct sched_cpu *sc;
+	int cpu;
+
 	/** Signalling the scheduler module unloading */
 	flag = 1;
-	/** Cancelling pending jobs in the Work Queue.*/
-	cancel_delayed_work(&scheduler_hdlr);
-	/** Removing all the pending jobs from the Work Queue*/
-	flush_workqueue(scheduler_wq);
-	/** Deallocating the Work Queue */
-	destroy_workqueue(scheduler_wq);
+	/**No new kick once this returns.*/
+	set_process_queue_resched(NULL);
+	for_each_possible_cpu(cpu) {
+		sc = per_cpu_ptr(&sched_cpus, cpu);
+		/** Waiting for a pending kick, it would arm the timer again.*/
+		irq_work_sync(&sc->kick_work);
+		/** Cancelling the dispatch timer, waits for a running callback.*/
+		hrtimer_cancel(&sc->timer);
+		/** Waiting for a pending steal.*/
+		cancel_work_sync(&sc->steal_work);
+	}
+
+	/**Handing the process queue back to its built in FIFO policy.*/
+	mutex_lock(&policy_mutex);
+	set_process_queue_policy(NULL);
+	if(active_policy->owner != THIS_MODULE) {
+		module_put(active_policy->owner);
+	}
+	active_policy = NULL;
+	mutex_unlock(&policy_mutex);
+	unregister_sched_policy(&dynamic_rr_policy);
+	unregister_sched_policy(&static_rr_policy);
 
 	printk(KERN_INFO "Process Scheduler module is being unloaded.\n");
 }
+
+/**
+	Function Name : tick_jitter_get
+	Function Type : Module Parameter Callback
+	Description   : Method reports the configured slice and the measured
+			tick jitter through /sys/module/process_scheduler/parameters/tick_jitter.
+*/
+static int tick_jitter_get(char *buffer, const struct kernel_param *kp)
+{
+	struct tick_jitter total = { .min_ns = U64_MAX }, *jitter;
+	u64 avg_ns;
+	int cpu;
+
+	/**Summing the jitter measured on every CPU.*/
+	for_each_possible_cpu(cpu) {
+		jitter = &per_cpu_ptr(&sched_cpus, cpu)->jitter;
+		total.samples += jitter->samples;
+		total.total_ns += jitter->total_ns;
+		total.min_ns = min(total.min_ns, jitter->min_ns);
+		total.max_ns = max(total.max_ns, jitter->max_ns);
+		total.overruns += jitter->overruns;
+		total.kicks += jitter->kicks;
+		total.stops += jitter->stops;
+	}
+	avg_ns = total.samples ? div64_u64(total.total_ns, total.samples) : 0;
+
+	return sprintf(buffer, "quantum_ns=%llu samples=%lu avg_ns=%llu min_ns=%llu max_ns=%llu overruns=%lu kicks=%lu stops=%lu\n",
+		quantum_ns, total.samples, avg_ns,
+		total.samples ? total.min_ns : 0, total.max_ns, total.overruns, total.kicks, total.stops);
+}
+
+/** Read only parameter operations for the tick jitter report. */
+static const struct kernel_param_ops tick_jitter_ops = {
+	.get =	tick_jitter_get,
+};
+
+/**
+	Function Name : policy_set
+	Function Type : Module Parameter Callback
+	Description   : Method selects the scheduling policy. At load time the
+			name is only stored, the init method installs it. Once
+			loaded, writing /sys/module/process_scheduler/parameters/policy
+			switches the policy without losing the registered processes.
+*/
+static int policy_set(const char *val, const struct kernel_param *kp)
+{
+	char name[SCHED_POLICY_NAME_MAX];
+	char *trimmed;
+
+	if(strscpy(name, val, sizeof(name)) < 0) {
+		return -EINVAL;
+	}
+	trimmed = strim(name);
+	/**Check if the module is still being loaded.*/
+	if(active_policy == NULL) {
+		strscpy(policy_name, trimmed, sizeof(policy_name));
+		return 0;
+	}
+	return activate_sched_policy(trimmed);
+}
+
+/**
+	Function Name : policy_get
+	Function Type : Module Parameter Callback
+	Description   : Method reports the installed scheduling policy.
+*/
+static int policy_get(char *buffer, const struct kernel_param *kp)
+{
+	return sprintf(buffer, "%s\n", policy_name);
+}
+
+/** Parameter operations for the scheduling policy. */
+static const struct kernel_param_ops policy_ops = {
+	.set =	policy_set,
+	.get =	policy_get,
+};
+
+/**
+	Function Name : available_policies_get
+	Function Type : Module Parameter Callback
+	Description   : Method lists the registered scheduling policies through
+			/sys/module/process_scheduler/parameters/available_policies.
+*/
+static int available_policies_get(char *buffer, const struct kernel_param *kp)
+{
+	struct sched_policy_ops *ops;
+	int len = 0;
+
+	mutex_lock(&policy_mutex);
+	list_for_each_entry(ops, &policy_list, list) {
+		len += scnprintf(buffer + len, PAGE_SIZE - len, "%s ", ops->name);
+	}
+	mutex_unlock(&policy_mutex);
+	len += scnprintf(buffer + len, PAGE_SIZE - len, "\n");
+	return len;
+}
+
+/** Read only parameter operations for the policy registry. */
+static const struct kernel_param_ops available_policies_ops = {
+	.get =	available_policies_get,
+};
+
 /** Initializing the kernel module init with custom init method */
 module_init(process_scheduler_module_init);
 /** Initializing the kernel module exit with custom cleanup method */
 module_exit(process_scheduler_module_cleanup);
 
+EXPORT_SYMBOL_GPL(register_sched_policy);
+EXPORT_SYMBOL_GPL(unregister_sched_policy);
+
 /**Initializing the time_quantum*/
-module_param(time_quantum, int, 0);
+module_param(time_quantum, int, 0444);
+/**Initializing the time_quantum_us*/
+module_param(time_quantum_us, ulong, 0444);
+/**Initializing the scheduling policy, writable at run time*/
+module_param_cb(policy, &policy_ops, NULL, 0644);
+/**Exposing the registered policies as a read only parameter.*/
+module_param_cb(available_policies, &available_policies_ops, NULL, 0444);
+/**Initializing the dynamic round robin bounds and reference length*/
+module_param(drr_min_quantum_us, ulong, 0);
+module_param(drr_max_quantum_us, ulong, 0);
+module_param(drr_ref_len, uint, 0);
+/**Exposing the tick jitter as a read only parameter.*/
+module_param_cb(tick_jitter, &tick_jitter_ops, NULL, 0444);
@@ -13,6 +13,16 @@
 #include <linux/kernel.h>
 #include <linux/list.h>
 #include <linux/slab.h>
+#include <linux/uaccess.h>
+#include <linux/string.h>
+#include <linux/ctype.h>
+#include <linux/sched.h>
+#include <linux/cred.h>
+#include <linux/capability.h>
+#include <linux/miscdevice.h>
+#include <linux/seq_file.h>
+#include "sched_policy.h"
+#include "process_sched_ioctl.h"
 
 
 MODULE_AUTHOR("Sreeram Sadasivam");
@@ -24,16 +34,10 @@ MODULE_LICENSE("GPL");
 
 /** STANDARD MACROS */
 #define BASE_10 		10
-
-/**Enumeration for Process States*/
-enum process_state {
-	
-	eCreated		=	0, /**Process in Created State*/
-	eRunning		=	1, /**Process in Running State*/
-	eWaiting		=	2, /**Process in Waiting State*/
-	eBlocked		=	3, /**Process in Blocked State*/
-	eTerminated		=	4  /**Process in Terminate State*/
-};
+/**Longest registration line, "pid key=value ..." or "group add name weight".*/
+#define MAX_SCHED_ADD_LEN	128
+/**Number of pids of a batch copied in and handled at a time.*/
+#define SCHED_BATCH_CHUNK	64
 
 /**Enumeration for Function Execution*/
 enum execution {
@@ -48,32 +52,278 @@ static struct proc_dir_entry *proc_sched_add_file_entry;
 
 /**External Function Prototypes for Process Queue Functions*/
 extern int add_process_to_queue(int pid);
+extern int add_process_to_queue_attr(int pid, const struct proc_sched_attr *attr);
 extern int remove_process_from_queue(int pid);
 extern int print_process_queue(void);
 extern int get_first_process_in_queue(void);
 extern int remove_terminated_processes_from_queue(void);
 extern int change_process_state_in_queue(int pid, int changeState);
+extern int print_process_queue_stats(struct seq_file *m);
+extern int yield_process_in_queue(int pid);
+
+/**Function Prototypes for the registration line parsing*/
+static char *next_sched_add_token(char **cur);
+static int sched_us_to_ns(u64 us, u64 *ns);
+static int parse_sched_add_line(char *line, int *pid, struct proc_sched_attr *attr);
+static int process_sched_group_command(char *line);
+static int process_sched_yield_command(char *line);
+static int sched_ioc_attr_convert(const struct proc_sched_ioc_attr *uattr, struct proc_sched_attr *attr);
+static int check_sched_permission(int pid, int *nr);
+static int check_sched_attr_permission(const struct proc_sched_attr *attr);
+static long process_sched_dev_ioctl(struct file *file, unsigned int cmd, unsigned long arg);
+
 /**
-	Function Name : process_sched_add_module_read
+	Function Name : process_sched_add_module_show
 	Function Type : Kernel Callback Method
-	Description   : Method is invoked whenever the process_sched_add 
-					file is	read. This callback method is triggered when
-					a read operation performed on the above mentioned 
-					file which is registered to the file operation 
-					object.	
-					Unfortunately, /proc/process_sched_add_module is a 
-					write-only file
-*/
-static ssize_t process_sched_add_module_read(struct file *file, char *buf, size_t count, loff_t *ppos)
+	Description   : Method is invoked whenever the process_sched_add
+					file is	read. It fills the seq_file with the
+					scheduling statistics of every CPU and every process,
+					see print_process_queue_stats.
+*/
+static int process_sched_add_module_show(struct seq_file *m, void *v)
 {
-	
-	printk(KERN_INFO "Process Scheduler Add Module read.\n");
-	//print_process_queue();
-	printk(KERN_INFO "Next Executable PID in the list if RR Scheduling: %d\n", get_first_process_in_queue());
-	/** Successful execution of read call back. EOF reached.*/
+	pr_debug("Process Scheduler Add Module read.\n");
+	return print_process_queue_stats(m);
+}
+
+
+/**
+	Function Name : next_sched_add_token
+	Function Type : Internal Method
+	Description   : Method returns the next non empty blank separated token
+					of the line and advances past it, or NULL at its end.
+*/
+static char *next_sched_add_token(char **cur)
+{
+	char *tok;
+
+	do {
+		tok = strsep(cur, " \t\n");
+	} while(tok != NULL && *tok == '\0');
+	return tok;
+}
+
+/**
+	Function Name : check_sched_permission
+	Function Type : Internal Method
+	Description   : Method checks the caller may schedule the given pid,
+					i.e. have it stopped, continued, pinned or removed.
+					CAP_SYS_NICE allows any pid, as for sched_setscheduler,
+					otherwise the caller must own the process, its
+					effective uid matching the real or effective uid of
+					the task. The pid is resolved in the namespace of the
+					caller, and nr is set to its number in the initial
+					namespace, the one the process queue takes. Returns 0,
+					-ESRCH or -EPERM.
+*/
+static int check_sched_permission(int pid, int *nr)
+{
+	const struct cred *cred = current_cred(), *pcred;
+	struct task_struct *task;
+	bool owner, nice = capable(CAP_SYS_NICE);
+
+	rcu_read_lock();
+	task = pid > 0 ? pid_task(find_vpid(pid), PIDTYPE_PID) : NULL;
+	if(task == NULL) {
+		rcu_read_unlock();
+		return -ESRCH;
+	}
+	*nr = task_pid_nr(task);
+	pcred = __task_cred(task);
+	owner = nice || uid_eq(cred->euid, pcred->euid) || uid_eq(cred->euid, pcred->uid);
+	rcu_read_unlock();
+	return owner ? 0 : -EPERM;
+}
+
+/**
+	Function Name : sched_us_to_ns
+	Function Type : Internal Method
+	Description   : Method converts a time given in microseconds into
+					nanoseconds. Returns 0, or -ERANGE if the result does
+					not fit.
+*/
+static int sched_us_to_ns(u64 us, u64 *ns)
+{
+	if(us > U64_MAX / NSEC_PER_USEC) {
+		return -ERANGE;
+	}
+	*ns = us * NSEC_PER_USEC;
 	return 0;
 }
 
+/**
+	Function Name : check_sched_attr_permission
+	Function Type : Internal Method
+	Description   : Method checks the caller may ask for the given
+					attributes. A reservation, or more tickets than
+					SCHED_TICKETS_DEFAULT, takes CPU time from the processes
+					of other users and needs CAP_SYS_NICE, as SCHED_DEADLINE
+					does. Returns 0 or -EPERM.
+*/
+static int check_sched_attr_permission(const struct proc_sched_attr *attr)
+{
+	if(attr->runtime_ns == 0 && attr->tickets <= SCHED_TICKETS_DEFAULT) {
+		return 0;
+	}
+	return capable(CAP_SYS_NICE) ? 0 : -EPERM;
+}
+
+/**
+	Function Name : parse_sched_add_line
+	Function Type : Internal Method
+	Description   : Method parses a registration line. The pid comes first,
+					followed either by the positional runtime, period and
+					optional deadline of a reservation in microseconds, or
+					by key=value fields among runtime_us, period_us,
+					deadline_us, tickets, cpu and group. cpu pins the
+					process to that CPU. The deadline defaults
+					to the period. Returns the number of attribute fields
+					given, 0 for a plain pid, -ERANGE for a time too large
+					or -EINVAL.
+*/
+static int parse_sched_add_line(char *line, int *pid, struct proc_sched_attr *attr)
+{
+	static const char *positional[] = { "runtime_us", "period_us", "deadline_us" };
+	char *cur = line, *tok, *val;
+	int fields = 0, positional_fields = 0;
+	bool has_deadline = false;
+	u64 num;
+	int ret = 0;
+
+	memset(attr, 0, sizeof(*attr));
+	/**The pid comes first.*/
+	tok = next_sched_add_token(&cur);
+	if(tok == NULL || kstrtoint(tok, BASE_10, pid) < 0) {
+		return -EINVAL;
+	}
+	while((tok = next_sched_add_token(&cur)) != NULL) {
+		/**The group is the only field holding a name.*/
+		if(strncmp(tok, "group=", 6) == 0) {
+			if(strscpy(attr->group, tok + 6, sizeof(attr->group)) <= 0) {
+				return -EINVAL;
+			}
+			fields++;
+			continue;
+		}
+		/**A bare number is the next positional field.*/
+		val = strchr(tok, '=');
+		if(val == NULL) {
+			if(positional_fields == ARRAY_SIZE(positional)) {
+				return -EINVAL;
+			}
+			val = tok;
+			tok = (char *)positional[positional_fields++];
+		}
+		else {
+			*val++ = '\0';
+		}
+		if(kstrtoull(val, BASE_10, &num) < 0) {
+			return -EINVAL;
+		}
+		if(strcmp(tok, "runtime_us") == 0) {
+			ret = sched_us_to_ns(num, &attr->runtime_ns);
+		}
+		else if(strcmp(tok, "period_us") == 0) {
+			ret = sched_us_to_ns(num, &attr->period_ns);
+		}
+		else if(strcmp(tok, "deadline_us") == 0) {
+			ret = sched_us_to_ns(num, &attr->deadline_ns);
+			has_deadline = true;
+		}
+		else if(strcmp(tok, "tickets") == 0) {
+			if(num == 0 || num > UINT_MAX) {
+				return -EINVAL;
+			}
+			attr->tickets = num;
+		}
+		else if(strcmp(tok, "cpu") == 0) {
+			if(num >= nr_cpu_ids) {
+				return -EINVAL;
+			}
+			attr->pinned = true;
+			attr->cpu = num;
+		}
+		else {
+			return -EINVAL;
+		}
+		if(ret < 0) {
+			return ret;
+		}
+		fields++;
+	}
+	/**A lone runtime is not a reservation.*/
+	if(positional_fields == 1) {
+		return -EINVAL;
+	}
+	if(!has_deadline) {
+		attr->deadline_ns = attr->period_ns;
+	}
+	return fields;
+}
+
+/**
+	Function Name : process_sched_group_command
+	Function Type : Internal Method
+	Description   : Method runs a group command, the line past the group
+					keyword. "add name [weight]" creates the group or
+					changes its weight, which defaults to
+					SCHED_GROUP_WEIGHT_DEFAULT. "del name" removes the
+					group, which must have no process left.
+*/
+static int process_sched_group_command(char *line)
+{
+	char *cur = line, *action, *name, *tok;
+	unsigned int weight = SCHED_GROUP_WEIGHT_DEFAULT;
+
+	action = next_sched_add_token(&cur);
+	name = next_sched_add_token(&cur);
+	if(action == NULL || name == NULL) {
+		return -EINVAL;
+	}
+	tok = next_sched_add_token(&cur);
+	if(strcmp(action, "add") == 0) {
+		if(tok != NULL && kstrtouint(tok, BASE_10, &weight) < 0) {
+			return -EINVAL;
+		}
+		if(tok != NULL && next_sched_add_token(&cur) != NULL) {
+			return -EINVAL;
+		}
+		return add_process_group(name, weight);
+	}
+	if(strcmp(action, "del") == 0 && tok == NULL) {
+		return remove_process_group(name);
+	}
+	return -EINVAL;
+}
+
+/**
+	Function Name : process_sched_yield_command
+	Function Type : Internal Method
+	Description   : Method runs a yield command, the line past the yield
+					keyword. The optional pid, the writer by default,
+					gives its CPU up before its slice ends.
+*/
+static int process_sched_yield_command(char *line)
+{
+	char *cur = line, *tok;
+	int pid = task_pid_nr(current), ret;
+
+	tok = next_sched_add_token(&cur);
+	if(tok != NULL && kstrtoint(tok, BASE_10, &pid) < 0) {
+		return -EINVAL;
+	}
+	if(tok != NULL && next_sched_add_token(&cur) != NULL) {
+		return -EINVAL;
+	}
+	/**Another pid is only yielded by its owner, or with CAP_SYS_NICE.*/
+	if(tok != NULL) {
+		ret = check_sched_permission(pid, &pid);
+		if(ret != 0) {
+			return ret;
+		}
+	}
+	return yield_process_in_queue(pid);
+}
 
 /**
 	Function Name : process_sched_add_module_write
@@ -83,29 +333,82 @@ static ssize_t process_sched_add_module_read(struct file *file, char *buf, size_
 					when a write operation performed on the above 
 					mentioned file which is registered to the file 
 					operation object. 
-					/proc/process_sched_add is a write only file.
+					Reading /proc/process_sched_add gives the statistics.
+					The line holds a pid, optionally followed by the
+					scheduling attributes, see parse_sched_add_line, or
+					a group command starting with the group keyword, see
+					process_sched_group_command, or a yield command, see
+					process_sched_yield_command.
 */
 static ssize_t process_sched_add_module_write(struct file *file, const char *buf, size_t count, loff_t *ppos)
 {
-	int ret;
-	long int new_proc_id;	
+	int ret, fields;
+	int new_proc_id;
+	struct proc_sched_attr attr;
+	char kbuf[MAX_SCHED_ADD_LEN];
 	
-	printk(KERN_INFO "Process Scheduler Add Module write.\n");
-	printk(KERN_INFO "Registered Process ID: %s\n", buf);
-	
-	ret = kstrtol(buf,BASE_10,&new_proc_id);
-	if(ret < 0) {
-		/** Invalid argument in conversion error.*/
+	pr_debug("Process Scheduler Add Module write.\n");
+
+	/**Copying the line out of user space, the buffer is not ours to read.*/
+	if(count == 0 || count >= sizeof(kbuf)) {
 		return -EINVAL;
 	}
+	if(copy_from_user(kbuf, buf, count)) {
+		return -EFAULT;
+	}
+	kbuf[count] = '\0';
+
+	/**Group commands start with the group keyword, registrations with a pid.*/
+	if(strncmp(kbuf, "group", 5) == 0 && isspace(kbuf[5])) {
+		/**The groups share every CPU among all the users.*/
+		if(!capable(CAP_SYS_NICE)) {
+			return -EPERM;
+		}
+		ret = process_sched_group_command(kbuf + 5);
+		if(ret != eExecSuccess) {
+			printk(KERN_ALERT "Process Set ERROR:group command failed from sched set write method");
+			/** Group command error, e.g. -EINVAL, -ENOENT for an unknown group or -EBUSY for a group still in use.*/
+			return ret;
+		}
+		return count;
+	}
+	if(strncmp(kbuf, "yield", 5) == 0 && (kbuf[5] == '\0' || isspace(kbuf[5]))) {
+		ret = process_sched_yield_command(kbuf + 5);
+		if(ret != eExecSuccess) {
+			printk(KERN_ALERT "Process Set ERROR:yield command failed from sched set write method");
+			/** Yield command error, e.g. -EINVAL or -ESRCH for a pid not registered.*/
+			return ret;
+		}
+		return count;
+	}
+
+	fields = parse_sched_add_line(kbuf, &new_proc_id, &attr);
+	if(fields < 0) {
+		/** Conversion error, -EINVAL for an invalid argument or -ERANGE for a time too large.*/
+		return fields;
+	}
+	/**Only the owner of the process, or a caller with CAP_SYS_NICE, registers it, only the latter with a reservation or extra tickets.*/
+	ret = check_sched_permission(new_proc_id, &new_proc_id);
+	if(ret == 0 && fields != 0) {
+		ret = check_sched_attr_permission(&attr);
+	}
+	if(ret != 0) {
+		return ret;
+	}
+	pr_debug("Registered Process ID: %d\n", new_proc_id);
 	
-	/**	Add process to the process queue.*/
-	ret = add_process_to_queue(new_proc_id);
+	/**	Add process to the process queue, with its attributes if any.*/
+	if(fields == 0) {
+		ret = add_process_to_queue(new_proc_id);
+	}
+	else {
+		ret = add_process_to_queue_attr(new_proc_id, &attr);
+	}
 	/**Check if the add process to queue method was successful or not.*/
 	if(ret != eExecSuccess) {
 		printk(KERN_ALERT "Process Set ERROR:add_process_to_queue function failed from sched set write method");
-		/** Add process to queue error.*/
-		return -ENOMEM;
+		/** Add process to queue error, e.g. -ENOMEM, -EEXIST for an already registered pid or -EBUSY for a reservation not admitted.*/
+		return ret;
 	}
 
 	/** Successful execution of write call back.*/
@@ -120,14 +423,15 @@ static ssize_t process_sched_add_module_write(struct file *file, const char *buf
 					when an open operation performed on the above 
 					mentioned file which is registered to the file 
 					operation object. 
-					/proc/process_sched_add is a write only file.
+					Reads of /proc/process_sched_add go through a
+					seq_file, which is set up here.
 */
 static int process_sched_add_module_open(struct inode * inode, struct file * file)
 {
-	printk(KERN_INFO "Process Scheduler Add Module open.\n");
+	pr_debug("Process Scheduler Add Module open.\n");
 	
-	/** Successful execution of open call back.*/
-	return 0;
+	/** Execution of open call back, the seq_file is allocated.*/
+	return single_open(file, process_sched_add_module_show, NULL);
 }
 
 /**
@@ -138,24 +442,169 @@ static int process_sched_add_module_open(struct inode * inode, struct file * fil
 			when an close operation performed on the above 
 			mentioned file which is registered to the file 
 			operation object. 
-			/proc/process_sched_add is a write only file.
+			The seq_file of the open is released.
 */
 static int process_sched_add_module_release(struct inode * inode, struct file * file)
 {
-	printk(KERN_INFO "Process Scheduler Add Module released.\n");
-	/** Successful execution of release callback.*/
-	return 0;
+	pr_debug("Process Scheduler Add Module released.\n");
+	/** Execution of release callback.*/
+	return single_release(inode, file);
 }
 
 /** File operations related to process_sched_add file */
 static struct file_operations process_sched_add_module_fops = {
 	.owner =	THIS_MODULE,
-	.read =		process_sched_add_module_read,
+	.read =		seq_read,
+	.llseek =	seq_lseek,
 	.write =	process_sched_add_module_write,
 	.open =		process_sched_add_module_open,
 	.release =	process_sched_add_module_release,
 };
 
+/**
+	Function Name : sched_ioc_attr_convert
+	Function Type : Internal Method
+	Description   : Method converts the binary attributes of one pid of a
+					batch, with the defaults of the text interface.
+					Returns -EINVAL on padding or an unterminated group,
+					-ERANGE for a time too large.
+*/
+static int sched_ioc_attr_convert(const struct proc_sched_ioc_attr *uattr, struct proc_sched_attr *attr)
+{
+	if(uattr->pad != 0 || memchr(uattr->group, '\0', sizeof(uattr->group)) == NULL) {
+		return -EINVAL;
+	}
+	memset(attr, 0, sizeof(*attr));
+	/**The times come from userspace, bounded before the conversion.*/
+	if(sched_us_to_ns(uattr->runtime_us, &attr->runtime_ns) < 0 || sched_us_to_ns(uattr->period_us, &attr->period_ns) < 0 || sched_us_to_ns(uattr->deadline_us, &attr->deadline_ns) < 0) {
+		return -ERANGE;
+	}
+	if(uattr->deadline_us == 0) {
+		attr->deadline_ns = attr->period_ns;
+	}
+	attr->tickets = uattr->tickets;
+	strscpy(attr->group, uattr->group, sizeof(attr->group));
+	return 0;
+}
+
+/**
+	Function Name : process_sched_dev_ioctl
+	Function Type : Kernel Callback Method
+	Description   : Method is invoked for an ioctl on /dev/process_sched.
+					PROC_SCHED_IOC_ADD registers and PROC_SCHED_IOC_REMOVE
+					removes every pid of a batch, see
+					process_sched_ioctl.h. The batch is copied in chunks,
+					a failed pid does not stop the others, its error is
+					stored in the results, -EPERM for a pid the caller may
+					not schedule, see check_sched_permission. Returns 0
+					once the batch is processed, with done set to the
+					number of pids that succeeded.
+*/
+static long process_sched_dev_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+	struct proc_sched_ioc_batch __user *ubatch = (struct proc_sched_ioc_batch __user *)arg;
+	struct proc_sched_ioc_batch batch;
+	struct proc_sched_ioc_attr *uattrs = NULL;
+	struct proc_sched_attr attr;
+	s32 *pids, *results;
+	u32 i, j, n, done = 0;
+	long ret = 0;
+
+	if(cmd != PROC_SCHED_IOC_ADD && cmd != PROC_SCHED_IOC_REMOVE) {
+		return -ENOTTY;
+	}
+	if(copy_from_user(&batch, ubatch, sizeof(batch))) {
+		return -EFAULT;
+	}
+	if(batch.count > PROC_SCHED_BATCH_MAX || (batch.count != 0 && batch.pids == 0) || (cmd == PROC_SCHED_IOC_REMOVE && batch.attrs != 0)) {
+		return -EINVAL;
+	}
+
+	/**One chunk of every array, the batch itself may be large.*/
+	pids = kmalloc_array(SCHED_BATCH_CHUNK, 2 * sizeof(s32), GFP_KERNEL);
+	if(pids == NULL) {
+		return -ENOMEM;
+	}
+	results = pids + SCHED_BATCH_CHUNK;
+	if(batch.attrs != 0) {
+		uattrs = kmalloc_array(SCHED_BATCH_CHUNK, sizeof(*uattrs), GFP_KERNEL);
+		if(uattrs == NULL) {
+			kfree(pids);
+			return -ENOMEM;
+		}
+	}
+
+	for(i = 0; i < batch.count; i += n) {
+		n = min_t(u32, SCHED_BATCH_CHUNK, batch.count - i);
+		if(copy_from_user(pids, u64_to_user_ptr(batch.pids) + i * sizeof(s32), n * sizeof(s32))) {
+			ret = -EFAULT;
+			break;
+		}
+		if(uattrs != NULL && copy_from_user(uattrs, u64_to_user_ptr(batch.attrs) + i * sizeof(*uattrs), n * sizeof(*uattrs))) {
+			ret = -EFAULT;
+			break;
+		}
+		for(j = 0; j < n; j++) {
+			/**Every pid is checked on its own, a foreign one fails with -EPERM.*/
+			results[j] = check_sched_permission(pids[j], &pids[j]);
+			if(results[j] != 0) {
+				continue;
+			}
+			if(cmd == PROC_SCHED_IOC_REMOVE) {
+				results[j] = remove_process_from_queue(pids[j]);
+			}
+			else if(uattrs == NULL) {
+				results[j] = add_process_to_queue(pids[j]);
+			}
+			else {
+				results[j] = sched_ioc_attr_convert(&uattrs[j], &attr);
+				if(results[j] == 0) {
+					results[j] = check_sched_attr_permission(&attr);
+				}
+				if(results[j] == 0) {
+					results[j] = add_process_to_queue_attr(pids[j], &attr);
+				}
+			}
+			if(results[j] == 0) {
+				done++;
+			}
+		}
+		if(batch.results != 0 && copy_to_user(u64_to_user_ptr(batch.results) + i * sizeof(s32), results, n * sizeof(s32))) {
+			ret = -EFAULT;
+			break;
+		}
+		/**A large batch gives the CPU up between chunks and stops for a dying caller.*/
+		if(fatal_signal_pending(current)) {
+			ret = -EINTR;
+			break;
+		}
+		cond_resched();
+	}
+	kfree(uattrs);
+	kfree(pids);
+
+	/**Reporting the pids processed, also when the batch stopped early.*/
+	if(put_user(done, &ubatch->done)) {
+		return -EFAULT;
+	}
+	return ret;
+}
+
+/** File operations related to the process_sched device */
+static const struct file_operations process_sched_dev_fops = {
+	.owner =			THIS_MODULE,
+	.unlocked_ioctl =	process_sched_dev_ioctl,
+	.compat_ioctl =		process_sched_dev_ioctl,
+};
+
+/** Misc device /dev/process_sched taking the batches */
+static struct miscdevice process_sched_dev = {
+	.minor =	MISC_DYNAMIC_MINOR,
+	.name =		PROC_SCHED_DEV_NAME,
+	.fops =		&process_sched_dev_fops,
+	.mode =		0600,
+};
+
 /**
 	Function Name : process_sched_add_module_init
 	Function Type : Module INIT
@@ -165,16 +614,25 @@ static struct file_operations process_sched_add_module_fops = {
 */
 static int __init process_sched_add_module_init(void)
 {
+	int ret;
+
 	printk(KERN_INFO "Process Add to Scheduler module is being loaded.\n");
 	
-	/**Proc FS is created with RD&WR permissions with name process_sched_add*/
-	proc_sched_add_file_entry = proc_create(PROC_CONFIG_FILE_NAME,0777,NULL,&process_sched_add_module_fops);
+	/**Proc FS is created with RD&WR permissions with name process_sched_add, every write checks the caller may schedule its pid.*/
+	proc_sched_add_file_entry = proc_create(PROC_CONFIG_FILE_NAME,0666,NULL,&process_sched_add_module_fops);
 	/** Condition to verify if process_sched_add creation was successful*/
 	if(proc_sched_add_file_entry == NULL) {
 		printk(KERN_ALERT "Error: Could not initialize /proc/%s\n",PROC_CONFIG_FILE_NAME);
 		/** File Creation problem.*/
 		return -ENOMEM;
 	}
+	/**Character device for the batched binary interface.*/
+	ret = misc_register(&process_sched_dev);
+	if(ret != 0) {
+		printk(KERN_ALERT "Error: Could not initialize /dev/%s\n", PROC_SCHED_DEV_NAME);
+		proc_remove(proc_sched_add_file_entry);
+		return ret;
+	}
 	
 	
 	/** Successful execution of initialization method. */
@@ -192,7 +650,8 @@ static void __exit process_sched_add_module_cleanup(void)
 {
 	
 	printk(KERN_INFO "Process Add to Scheduler module is being unloaded.\n");
-	/** Proc FS object removed.*/
+	/** Character device and Proc FS object removed.*/
+	misc_deregister(&process_sched_dev);
 	proc_remove(proc_sched_add_file_entry);
 }
 /** Initializing the kernel module init with custom init method */
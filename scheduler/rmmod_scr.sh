@@ -1,3 +1,7 @@
 sudo rmmod process_set.ko
+sudo rmmod policy_stride.ko
+sudo rmmod policy_mlfq.ko
+sudo rmmod policy_edf.ko
+sudo rmmod policy_fair.ko
 sudo rmmod process_scheduler.ko
 sudo rmmod process_queue.ko
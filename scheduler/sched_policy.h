@@ -0,0 +1,227 @@
+/**
+	\file	:	sched_policy.h
+	\author	: 	Sreeram Sadasivam
+	\brief	:	Interface shared by the process queue, the process scheduler and
+				the scheduling policy modules. A policy is a table of hooks the
+				process queue calls under the run queue spinlock to order the
+				waiting processes of one group on one CPU and to pick the next
+				one. The groups of a CPU are picked by their weighted CPU time.
+*/
+#ifndef _SCHED_POLICY_H
+#define _SCHED_POLICY_H
+
+#include <linux/module.h>
+#include <linux/types.h>
+#include <linux/kernel.h>
+#include <linux/list.h>
+#include <linux/rbtree.h>
+#include <linux/spinlock.h>
+#include <linux/pid.h>
+#include <linux/atomic.h>
+#include <linux/percpu.h>
+
+/**Macros*/
+#define ALL_REG_PIDS	-100
+#define	INVALID_PID		-1
+/**Longest policy name, terminating NUL included.*/
+#define SCHED_POLICY_NAME_MAX	16
+/**Longest group name, terminating NUL included.*/
+#define SCHED_GROUP_NAME_MAX	16
+/**Name of the group holding the processes registered without one.*/
+#define SCHED_GROUP_DEFAULT		"default"
+/**Weight of the default group, the unit of the group weights.*/
+#define SCHED_GROUP_WEIGHT_DEFAULT	1024
+/**Largest group weight.*/
+#define SCHED_GROUP_WEIGHT_MAX		(1024 * 1024)
+/**Tickets of a process registered without a ticket count, the most an unprivileged caller may ask for.*/
+#define SCHED_TICKETS_DEFAULT		100
+/**Slice of a CPU where nothing waits, its tick stops until a process is enqueued.*/
+#define SCHED_SLICE_TICKLESS		U64_MAX
+
+/**Enumeration for Process States*/
+enum process_state {
+
+	eCreated		=	0, /**Process in Created State*/
+	eRunning		=	1, /**Process in Running State*/
+	eWaiting		=	2, /**Process in Waiting State*/
+	eBlocked		=	3, /**Process in Blocked State*/
+	eTerminated		=	4  /**Process in Terminate State*/
+};
+
+/**
+	Structure for the scheduling attributes given at registration. A zero
+	runtime means the process has no reservation and is best effort.
+	Every policy reads the attributes it knows and ignores the others.
+*/
+struct proc_sched_attr {
+
+	u64 runtime_ns;				/**CPU time reserved in every period.*/
+	u64 period_ns;				/**Period of the reservation.*/
+	u64 deadline_ns;			/**Deadline relative to the start of every period.*/
+	unsigned int tickets;		/**Share of the proportional share policies, 0 for the default.*/
+	bool pinned;				/**The process is placed on cpu and never stolen.*/
+	unsigned int cpu;			/**CPU of a pinned process.*/
+	char group[SCHED_GROUP_NAME_MAX];	/**Group of the process, empty for the default group.*/
+};
+
+/**
+	Structure for the policy side of a process. Owned by the policy of the
+	run queue holding the process, which links it in its own structure.
+*/
+struct sched_policy_entity {
+
+	struct list_head run_list;	/**Link of list based policies.*/
+	struct rb_node run_node;	/**Link of tree based policies.*/
+	bool on_rq;					/**Set while the process is enqueued in the policy.*/
+	u64 vruntime;				/**Weighted CPU time of the fair policy.*/
+	unsigned long weight;		/**Load weight of the fair policy, from the nice value.*/
+	u64 deadline;				/**Absolute deadline of the current job, EDF policy.*/
+	u64 release;				/**Start of the current period, EDF policy.*/
+	u64 budget_ns;				/**Runtime left in the current period, EDF policy.*/
+	bool throttled;				/**Budget spent, waiting for the next period, EDF policy.*/
+	unsigned long nr_missed;	/**Number of deadlines missed, EDF policy.*/
+	unsigned int level;			/**Priority level, 0 the highest, MLFQ policy.*/
+	u64 allot_ns;				/**CPU time used at the current level over its slices, MLFQ policy.*/
+	u64 pass;					/**Virtual time of the stride policy.*/
+	u64 subtree_tickets;		/**Tickets of the subtree rooted here, lottery policy.*/
+};
+
+/**
+	Structure for the scheduling statistics of a process. Updated under the
+	run queue spinlock on every state change, read locklessly.
+*/
+struct proc_sched_stats {
+
+	u64 registered_ns;			/**Time of the registration.*/
+	u64 stamp_ns;				/**Time of the last state change.*/
+	u64 run_ns;					/**Time spent dispatched.*/
+	u64 wait_ns;				/**Time spent waiting for a dispatch, time asleep excluded.*/
+	u64 first_dispatch_ns;		/**Time from the registration to the first dispatch.*/
+	unsigned long nr_dispatches;	/**Number of times the process was dispatched.*/
+	unsigned long nr_preemptions;	/**Number of times it got off the CPU still runnable.*/
+};
+
+struct proc_group;
+struct proc_gang;
+struct proc_cpu_rq;
+
+/**
+	Structure for the task state change of a process, or of a gang, pending
+	for the enforcement work of a CPU when the backend sleeps. A change
+	asked for before the previous one is applied replaces it, so only the
+	latest state of every target waits and none is lost.
+*/
+struct enforce_pending {
+
+	struct list_head list;		/**Link in the pending changes of rq, empty if none.*/
+	struct proc_cpu_rq *rq;		/**Run queue whose work last took the change, NULL if never.*/
+	struct pid *pid_ref;		/**Counted reference to the task to change while pending.*/
+	enum process_state state;	/**eRunning or eWaiting.*/
+	int cpu;					/**CPU handed to the backend.*/
+};
+
+/** Structure for a process */
+struct proc {
+
+	int pid; 					/**Process ID*/
+	struct pid *pid_ref;		/**Counted reference to the pid, taken once at registration.*/
+	enum process_state state;	/**Process State*/
+	int cpu;					/**CPU whose run queue holds the process.*/
+	u64 dispatch_cputime_ns;	/**CPU time of the task when it was last dispatched.*/
+	u64 last_burst_ns;			/**CPU time the task consumed during its last slice.*/
+	struct list_head list;		/**List pointer for generating a list of processes.*/
+	struct hlist_node hnode;	/**Hash node indexing the process by its pid.*/
+	struct list_head block_list;	/**Link in the blocked processes of its CPU.*/
+	struct rcu_head rcu;		/**RCU head deferring the release past concurrent readers.*/
+	struct proc_sched_attr attr;	/**Scheduling attributes given at registration.*/
+	struct proc_group *group;	/**Group of the process, it waits in the sub-queue of the group on its CPU.*/
+	struct sched_policy_entity se;	/**Policy side of the process.*/
+	struct proc_sched_stats stats;	/**Scheduling statistics of the process.*/
+	struct proc_gang *gang;		/**Gang of the thread group of the process, its threads run as a unit.*/
+	struct list_head gang_list;	/**Link in the members of the gang.*/
+	bool gang_on;				/**Counted as dispatched by the gang.*/
+	struct enforce_pending enforce;	/**Task state change of the process pending for a backend that sleeps.*/
+	/**More things to come in future such as nice value, priority etc,.*/
+};
+
+struct sched_policy_ops;
+
+/**
+	Structure for the run queue of one group on one CPU, the sub-queue the
+	policy orders. Protected by the spinlock of the CPU run queue.
+*/
+struct proc_rq {
+
+	struct proc top;			/**Head of the list of processes of the group assigned to this CPU, in registration order.*/
+	unsigned int nr_procs;		/**Number of processes in the list, the running one included.*/
+	struct proc *curr;			/**Process of the group currently dispatched on this CPU or NULL.*/
+	u64 burst_sum_ns;			/**Sum of last_burst_ns over the processes in the list.*/
+	int cpu;					/**CPU owning the run queue.*/
+	struct list_head fifo;		/**Waiting processes of the built in FIFO policy.*/
+	struct sched_policy_ops *policy;	/**Policy ordering the waiting processes.*/
+	void *policy_priv;			/**Per run queue data of the policy, rq_priv_size bytes.*/
+	struct proc_group *group;	/**Group owning the run queue.*/
+	struct rb_node group_node;	/**Link in the tree of the groups of the CPU with waiting processes.*/
+	u64 vruntime;				/**CPU time the group used on this CPU scaled by its weight.*/
+	unsigned int nr_waiting;	/**Number of processes enqueued in the policy.*/
+};
+
+/**
+	Structure for a scheduling group. Every group has a sub-queue on every
+	possible CPU and receives a share of each CPU in proportion to its
+	weight, whatever the number of its processes.
+*/
+struct proc_group {
+
+	struct list_head list;				/**Link in the list of groups, walked under RCU.*/
+	char name[SCHED_GROUP_NAME_MAX];	/**Name used to select the group.*/
+	unsigned int weight;				/**Share of the group, SCHED_GROUP_WEIGHT_DEFAULT for the default one.*/
+	atomic_t nr_procs;					/**Number of registered processes, the group is removable at 0.*/
+	struct proc_rq __percpu *rqs;		/**Sub-queue of the group on every CPU.*/
+	void __percpu *policy_priv_area;	/**Per CPU data of the installed policy, NULL while it needs none.*/
+};
+
+/**
+	Structure for a scheduling policy. Every hook but the registration
+	fields runs with the run queue spinlock held and interrupts disabled,
+	so it must not sleep. The running process is never enqueued, it is
+	given back to the policy through enqueue once its slice is over.
+*/
+struct sched_policy_ops {
+
+	struct list_head list;				/**Link in the scheduler policy registry.*/
+	char name[SCHED_POLICY_NAME_MAX];	/**Name used to select the policy.*/
+	struct module *owner;				/**Module implementing the policy.*/
+	size_t rq_priv_size;				/**Size of the zeroed per run queue data, may be 0.*/
+
+	/**Mandatory hooks.*/
+	void (*enqueue)(struct proc_rq *rq, struct proc *p);	/**p becomes a waiting process of rq.*/
+	void (*dequeue)(struct proc_rq *rq, struct proc *p);	/**p stops waiting on rq.*/
+	struct proc *(*pick_next)(struct proc_rq *rq);			/**Next process to run, left enqueued, or NULL.*/
+
+	/**Optional hooks.*/
+	void (*tick)(struct proc_rq *rq, struct proc *p, u64 ran_ns);	/**p ran ran_ns of CPU time and gets off the CPU, in eBlocked state if it went to sleep.*/
+	void (*task_dead)(struct proc_rq *rq, struct proc *p);			/**p leaves the scheduler for good.*/
+	u64 (*timeslice)(struct proc_rq *rq, struct proc *curr);		/**Slice of curr, 0 for the default. With curr NULL on an idle CPU, the time until the policy needs a switch, 0 for none.*/
+	void (*init_rq)(struct proc_rq *rq);	/**rq switches to the policy, before the enqueues.*/
+	void (*exit_rq)(struct proc_rq *rq);	/**rq leaves the policy, after the dequeues.*/
+	int (*admit)(struct proc_rq *rq, struct proc *p);			/**New p may join rq, -EBUSY if not.*/
+	bool (*can_migrate)(struct proc_rq *rq, struct proc *p);	/**Waiting p may be stolen from rq.*/
+	bool (*check_preempt)(struct proc_rq *rq, struct proc *curr, struct proc *p);	/**p, just enqueued, takes the CPU from curr of rq at once.*/
+};
+
+/**Process Queue Functions for the scheduling policies*/
+extern void fifo_enqueue_process(struct proc_rq *rq, struct proc *p);
+extern void fifo_dequeue_process(struct proc_rq *rq, struct proc *p);
+extern struct proc *fifo_pick_next_process(struct proc_rq *rq);
+extern int set_process_queue_policy(struct sched_policy_ops *ops);
+extern int add_process_to_queue_attr(int pid, const struct proc_sched_attr *attr);
+extern int add_process_group(const char *name, unsigned int weight);
+extern int remove_process_group(const char *name);
+extern unsigned int process_group_total_weight(void);
+
+/**Process Scheduler Functions for the scheduling policy modules*/
+extern int register_sched_policy(struct sched_policy_ops *ops);
+extern void unregister_sched_policy(struct sched_policy_ops *ops);
+
+#endif